@@ -4,6 +4,10 @@
 // Created November 21, 2013
 //
 // Does Bluetooth I/O over Serial port.
+//
+// Commands from the controller are passed straight through to the game.
+// Commands from the game are parsed, so that the link setup commands (see
+// bt_receiver.h) can be handled here instead of being forwarded.
 
 #include <ble_shield.h>
 #include <SoftwareSerial.h>
@@ -11,21 +15,140 @@
 static const int RX_PIN = 6;
 static const int TX_PIN = 7;
 
+// Clear-to-send line to the game. Held low while sending to the game, since
+// SoftwareSerial can't receive at the same time.
+static const int CTS_PIN = 5;
+
+// Baud rates of the link to the game. Must match BT_BAUD_RATES in the game's
+// bt_receiver.h.
+static const long baud_rates[] = {9600, 19200, 38400, 57600};
+static const int num_baud_rates = sizeof(baud_rates) / sizeof(baud_rates[0]);
+
+// Time to wait for the game to confirm a new baud rate before going back to
+// the initial rate, in milliseconds.
+static const unsigned long confirm_timeout = 100;
+
+// Longest command sent by the game, including the header.
+static const int max_command_length = 6;
+
+// Time after which a command from the game that is still missing bytes is
+// dropped, in milliseconds. Bytes sent by the game at another baud rate (e.g.
+// while it looks for the rate in use after a reset) arrive as garbage, which
+// could otherwise swallow the start of the next hello.
+static const unsigned long command_timeout = 20;
+
 SoftwareSerial BLESerial(RX_PIN, TX_PIN); // RX, TX
 
+// Index of the baud rate in use.
+static int baud_index = 0;
+
+// Whether the game has yet to confirm the current baud rate, and since when.
+static boolean confirm_pending = false;
+static unsigned long confirm_start = 0;
+
+// Command from the game that is being received.
+static uint8_t command[max_command_length];
+static int command_count = 0;
+static unsigned long command_time = 0;
+
+// Returns the number of bytes that follow a header sent by the game.
+static int payload_length(uint8_t header);
+
+// Adds a byte received from the game to the command being received, and
+// handles the command once it is complete.
+static void receive_from_game(uint8_t byte);
+
+// Answers a link hello from the game and switches to the proposed rate.
+static void handle_hello(uint8_t index);
+
+// Restarts the link to the game at a baud rate.
+static void set_baud(int index);
+
 void setup() {
-	BLESerial.begin(9600);
+	pinMode(CTS_PIN, OUTPUT);
+	digitalWrite(CTS_PIN, HIGH);
+	BLESerial.begin(baud_rates[0]);
 	ble_begin();
 }
 
 void loop() {
 	ble_do_events();
-	if (!ble_connected()) return;
 
-	while (ble_available()) {
-		BLESerial.write(ble_read());
+	// Go back to the initial rate if the game never confirmed the new one.
+	if (confirm_pending && millis() - confirm_start >= confirm_timeout) {
+		set_baud(0);
+	}
+
+	// Drop a command that stopped partway.
+	if (command_count > 0 && millis() - command_time >= command_timeout) {
+		command_count = 0;
 	}
+
 	while (BLESerial.available()) {
-		ble_write(BLESerial.read());
+		receive_from_game(BLESerial.read());
 	}
+	if (!ble_connected()) return;
+
+	if (ble_available()) {
+		digitalWrite(CTS_PIN, LOW);
+		while (ble_available()) {
+			BLESerial.write(ble_read());
+		}
+		digitalWrite(CTS_PIN, HIGH);
+	}
+}
+
+static int payload_length(uint8_t header) {
+	switch (header) {
+		case 0x04: // Score
+		case 0x05: // High score
+			return 4;
+		case 0x06: // Link hello
+			return 1;
+		case 0x09: // Ping
+			return 5;
+		default:
+			return 0;
+	}
+}
+
+static void receive_from_game(uint8_t byte) {
+	command_time = millis();
+	command[command_count++] = byte;
+	if (command_count <= payload_length(command[0])) return;
+
+	if (command[0] == 0x06) {
+		handle_hello(command[1]);
+	} else if (ble_connected()) {
+		for (int i = 0; i < command_count; i++) {
+			ble_write(command[i]);
+		}
+	}
+	command_count = 0;
+}
+
+static void handle_hello(uint8_t index) {
+	if (index >= num_baud_rates) return;
+
+	// Acknowledge at the current rate before switching.
+	digitalWrite(CTS_PIN, LOW);
+	BLESerial.write(0x07);
+	BLESerial.write(index);
+	digitalWrite(CTS_PIN, HIGH);
+
+	if (index == baud_index) {
+		// The game has confirmed the rate in use.
+		confirm_pending = false;
+	} else {
+		set_baud(index);
+		confirm_pending = true;
+		confirm_start = millis();
+	}
+}
+
+static void set_baud(int index) {
+	baud_index = index;
+	confirm_pending = false;
+	BLESerial.end();
+	BLESerial.begin(baud_rates[index]);
 }
@@ -0,0 +1,55 @@
+// ArduinoCopter
+// arena.cpp
+//
+// Created October 19, 2026
+//
+
+#include "arena.h"
+
+// =========== Global Variables ============
+
+static uint8_t *arena_buffer = NULL;
+static size_t buffer_size = 0;
+
+// Bytes allocated from the start of the buffer.
+static size_t used = 0;
+static size_t peak = 0;
+
+// =========== Public API ============
+// All Public APIs are documented in arena.h
+
+void arena_init(uint8_t *buffer, size_t size) {
+    arena_buffer = buffer;
+    buffer_size = size;
+    used = 0;
+    peak = 0;
+}
+
+void *arena_alloc(size_t size) {
+    size_t bytes = ARENA_BYTES(size);
+    if (bytes > buffer_size - used) {
+        return NULL;
+    }
+    void *ptr = arena_buffer + used;
+    used += bytes;
+    peak = max(peak, used);
+    return ptr;
+}
+
+void arena_free(void *ptr, size_t size) {
+    if (ptr != NULL && (uint8_t *)ptr + ARENA_BYTES(size) == arena_buffer + used) {
+        used -= ARENA_BYTES(size);
+    }
+}
+
+size_t arena_used() {
+    return used;
+}
+
+size_t arena_peak() {
+    return peak;
+}
+
+size_t arena_size() {
+    return buffer_size;
+}
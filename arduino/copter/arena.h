@@ -0,0 +1,64 @@
+// ArduinoCopter
+// arena.h
+//
+// Created October 19, 2026
+//
+// Static memory for the game state. The scene, its generator and verifier, and
+// their arrays are allocated from a buffer that is sized at compile time (see
+// SCENE_MEMORY_BYTES()), so none of it comes from malloc(). Allocating moves a
+// pointer up the buffer. Freeing the last allocation moves it back down, so
+// freeing everything in the reverse order that it was allocated in (as
+// scene_free() does) returns all of it; anything else is only returned by
+// setting the arena up again with arena_init().
+//
+// Allocations are made through MEMORY_ALLOC() and MEMORY_FREE() (see
+// memory_stats.h), which also count them when MEMORY_STATS is defined.
+
+#ifndef __arena_h__
+#define __arena_h__
+#include <Arduino.h>
+
+// Alignment of every allocation. The AVR doesn't need any, but the host builds
+// of the game core do.
+#define ARENA_ALIGNMENT __BIGGEST_ALIGNMENT__
+
+// Number of bytes that an allocation of `size` bytes takes up in the arena.
+#define ARENA_BYTES(size) (((size) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT)
+
+// Declares a buffer for the arena.
+//
+// @param name  Name of the buffer.
+// @param size  Size of the buffer in bytes.
+#define ARENA_BUFFER(name, size) uint8_t name[size] __attribute__((aligned(ARENA_ALIGNMENT)))
+
+// Sets up the arena to allocate from a buffer, which must have been declared
+// with ARENA_BUFFER(). Anything allocated before is lost.
+//
+// @param buffer    The buffer.
+// @param size      Size of the buffer in bytes.
+void arena_init(uint8_t *buffer, size_t size);
+
+// Allocates memory from the arena.
+//
+// @param size Number of bytes to allocate.
+//
+// @return The allocated memory, or NULL if there isn't enough left.
+void *arena_alloc(size_t size);
+
+// Frees memory allocated with arena_alloc(). The memory is only returned to the
+// arena if it is the last allocation that hasn't been freed.
+//
+// @param ptr   The memory to free.
+// @param size  The size that was passed to arena_alloc().
+void arena_free(void *ptr, size_t size);
+
+// Returns the number of bytes allocated from the arena.
+size_t arena_used();
+
+// Returns the most bytes that have been allocated from the arena at once.
+size_t arena_peak();
+
+// Returns the size of the arena's buffer in bytes.
+size_t arena_size();
+
+#endif
@@ -0,0 +1,63 @@
+// ArduinoCopter
+// assets.cpp
+//
+// Generated by tools/asset_compiler.py from the files in assets/.
+// Do not edit; change the assets and run `make assets` instead.
+//
+
+#include "assets.h"
+
+// =========== helicopter.txt ============
+
+const uint8_t helicopter_body[] PROGMEM = {
+    0x00, 0x08, 0x1C, 0x08, 0x08, 0x18, 0x3C, 0x3E, 0x3C, 0x18, 0x00
+};
+
+const uint8_t helicopter_blade_left[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00
+};
+
+const uint8_t helicopter_blade_right[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01
+};
+
+// =========== hud_glyphs.txt ============
+
+const uint8_t hud_glyphs[][5] PROGMEM = {
+    {0x3E, 0x51, 0x49, 0x45, 0x3E},
+    {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x42, 0x61, 0x51, 0x49, 0x46},
+    {0x21, 0x41, 0x45, 0x4B, 0x31},
+    {0x18, 0x14, 0x12, 0x7F, 0x10},
+    {0x27, 0x45, 0x45, 0x45, 0x39},
+    {0x3C, 0x4A, 0x49, 0x49, 0x30},
+    {0x01, 0x71, 0x09, 0x05, 0x03},
+    {0x36, 0x49, 0x49, 0x49, 0x36},
+    {0x06, 0x49, 0x49, 0x29, 0x1E},
+    {0x00, 0x00, 0x00, 0x00, 0x00}
+};
+
+// =========== intro_logo.txt ============
+
+const uint16_t intro_logo_palette[] PROGMEM = {0x0000, 0xFFFF, 0xFFE0};
+const uint8_t intro_logo[] PROGMEM = {
+    0x0C, 0x00, 0x15, 0x02, 0x0C, 0x00, 0x15, 0x02, 0x0C, 0x00, 0x15, 0x02,
+    0x15, 0x00, 0x03, 0x01, 0x1E, 0x00, 0x03, 0x01, 0x1E, 0x00, 0x03, 0x01,
+    0x0F, 0x00, 0x03, 0x01, 0x09, 0x00, 0x09, 0x01, 0x0C, 0x00, 0x03, 0x01,
+    0x09, 0x00, 0x09, 0x01, 0x0C, 0x00, 0x03, 0x01, 0x09, 0x00, 0x09, 0x01,
+    0x09, 0x00, 0x1B, 0x01, 0x06, 0x00, 0x1B, 0x01, 0x06, 0x00, 0x1B, 0x01,
+    0x09, 0x00, 0x03, 0x01, 0x06, 0x00, 0x0F, 0x01, 0x09, 0x00, 0x03, 0x01,
+    0x06, 0x00, 0x0F, 0x01, 0x09, 0x00, 0x03, 0x01, 0x06, 0x00, 0x0F, 0x01,
+    0x15, 0x00, 0x09, 0x01, 0x18, 0x00, 0x09, 0x01, 0x18, 0x00, 0x09, 0x01,
+    0x06, 0x00
+};
+
+// =========== strings.txt ============
+
+const char intro_title[] PROGMEM = "Copter";
+const char intro_authors[] PROGMEM = "By Indragie Karuna\n  ratne & Jiawei Wu";
+const char intro_action[] PROGMEM = "Press button to\n        begin.";
+const char game_over_title[] PROGMEM = "Game Over";
+const char game_over_score[] PROGMEM = "Score: ";
+const char game_over_high_score[] PROGMEM = "\n  High Score: ";
+const char game_over_action[] PROGMEM = "Press button to\n        retry.";
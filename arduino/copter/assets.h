@@ -0,0 +1,52 @@
+// ArduinoCopter
+// assets.h
+//
+// Generated by tools/asset_compiler.py from the files in assets/.
+// Do not edit; change the assets and run `make assets` instead.
+//
+
+#ifndef __assets_h__
+#define __assets_h__
+#include <Arduino.h>
+
+// =========== helicopter.txt ============
+
+#define HELICOPTER_BODY_WIDTH 11
+#define HELICOPTER_BODY_HEIGHT 6
+extern const uint8_t helicopter_body[] PROGMEM;
+
+#define HELICOPTER_BLADE_LEFT_WIDTH 11
+#define HELICOPTER_BLADE_LEFT_HEIGHT 1
+extern const uint8_t helicopter_blade_left[] PROGMEM;
+
+#define HELICOPTER_BLADE_RIGHT_WIDTH 11
+#define HELICOPTER_BLADE_RIGHT_HEIGHT 1
+extern const uint8_t helicopter_blade_right[] PROGMEM;
+
+// =========== hud_glyphs.txt ============
+
+#define HUD_GLYPHS_BLANK 10
+#define HUD_GLYPHS_WIDTH 5
+#define HUD_GLYPHS_HEIGHT 7
+#define HUD_GLYPHS_COUNT 11
+extern const uint8_t hud_glyphs[][5] PROGMEM;
+
+// =========== intro_logo.txt ============
+
+#define INTRO_LOGO_WIDTH 33
+#define INTRO_LOGO_HEIGHT 18
+#define INTRO_LOGO_RUNS 49
+extern const uint16_t intro_logo_palette[] PROGMEM;
+extern const uint8_t intro_logo[] PROGMEM;
+
+// =========== strings.txt ============
+
+extern const char intro_title[] PROGMEM;
+extern const char intro_authors[] PROGMEM;
+extern const char intro_action[] PROGMEM;
+extern const char game_over_title[] PROGMEM;
+extern const char game_over_score[] PROGMEM;
+extern const char game_over_high_score[] PROGMEM;
+extern const char game_over_action[] PROGMEM;
+
+#endif
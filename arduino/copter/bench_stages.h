@@ -0,0 +1,38 @@
+// ArduinoCopter
+// bench_stages.h
+//
+// Created October 19, 2026
+//
+// Stage markers for the simulator benchmark in tools/avr_bench. Each marker
+// writes the number of the stage that is starting to GPIOR0, which costs a
+// single cycle on the board. The benchmark runner watches the register and
+// adds up the cycles spent in each stage.
+//
+// Only compiled in when BENCH_STAGES is defined, which the benchmark build does.
+
+#ifndef __bench_stages_h__
+#define __bench_stages_h__
+#include <Arduino.h>
+
+// Stages of a tick. Must match the names in tools/avr_bench/bench_runner.c.
+typedef enum {
+    bench_stage_none = 0,           // Outside of any stage.
+    bench_stage_redraw_frames,      // scene_update(): redrawing the scrolled terrain.
+    bench_stage_update_frames,      // scene_update(): popping frames and placing blocks.
+    bench_stage_redraw_blocks,      // scene_update(): redrawing the moved blocks.
+    bench_stage_update_blocks,      // scene_update(): moving and removing blocks.
+    bench_stage_update_copter,      // scene_update(): copter physics.
+    bench_stage_draw_copter,        // scene_update(): compositing the copter.
+    bench_stage_collision,          // scene_update(): collision detection.
+    bench_stage_idle,               // scene_idle(): generating upcoming frames.
+    bench_stage_tick = 0x40,        // Start of a tick, before the input is read.
+    bench_stage_done = 0xFF         // The session has finished.
+} bench_stage;
+
+#ifdef BENCH_STAGES
+#define BENCH_STAGE(stage) (GPIOR0 = (stage))
+#else
+#define BENCH_STAGE(stage)
+#endif
+
+#endif
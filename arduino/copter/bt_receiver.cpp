@@ -9,8 +9,108 @@
 
 static BTCallbackFunctions callbacks;
 
+// =========== Constants ============
+
+static const long baud_rates[] = BT_BAUD_RATES;
+static const int num_baud_rates = sizeof(baud_rates) / sizeof(baud_rates[0]);
+
+// Time to wait for the bridge to acknowledge a hello, in milliseconds.
+static const unsigned long link_reply_timeout = 50;
+
+// Number of times the first hello is sent, in case the bridge is still starting up.
+static const int link_hello_attempts = 4;
+
+// Number of times a hello is sent at each faster rate when looking for a
+// bridge that is still at a rate confirmed before the game was reset. The
+// bytes sent at other rates can leave a garbled command in the bridge, which
+// it drops after a moment, so one hello isn't always enough.
+static const int link_probe_attempts = 2;
+
+// Time to wait after a failed switch for the bridge to go back to the initial
+// rate, in milliseconds. Must be longer than the confirmation timeout of the bridge.
+static const unsigned long link_fallback_delay = 150;
+
+// Time between pings to the controller, and time after which a ping that
+// hasn't been answered counts as lost, in milliseconds.
+static const unsigned long ping_interval = 500;
+static const unsigned long ping_timeout = 1000;
+
+// How far a sequenced button press can be behind the expected sequence number
+// and still count as a late duplicate, and how far ahead it can be and still
+// count the ones in between as lost. Anything further off is taken to be a
+// controller that started counting again (e.g. the app was relaunched), and
+// the sequence is picked up from the press.
+static const uint8_t button_duplicate_window = 8;
+static const uint8_t button_max_gap = 32;
+
+// =========== Global Variables ============
+
+// Index of the baud rate in use.
+static int baud_index = 0;
+
+// Clear-to-send pin of the bridge.
+static int cts = -1;
+
+// Whether anything has been received from the controller. Pings are only sent
+// once it has, so that a missing controller doesn't count as a lossy link.
+static boolean controller_seen = false;
+
+// The ping waiting to be answered, if any.
+static boolean ping_pending = false;
+static uint8_t ping_sequence = 0;
+static unsigned long ping_time = 0;
+
+// Sequence number expected for the next sequenced button press, once one has
+// been received since the sequence was last picked up again.
+static boolean button_sequence_seen = false;
+static uint8_t button_sequence = 0;
+
+static BTLinkStats stats;
+
 // =========== Function Declarations ============
 
+// Steps the link up to the fastest baud rate that the bridge confirms.
+static void bt_receiver_negotiate_baud();
+
+// Looks for a bridge that is still at one of the faster baud rates, and leaves
+// the link at the rate that it is found at, or at the initial rate.
+static void bt_receiver_probe_baud();
+
+// Sends a link hello and waits for the bridge to acknowledge it.
+//
+// @param index Index of the baud rate to propose.
+//
+// @return Whether the bridge acknowledged the rate in time.
+static boolean bt_receiver_hello(int index);
+
+// Sends a ping when one is due, and gives up on the last ping if it has
+// timed out.
+static void bt_receiver_update_ping();
+
+// Handles a pong from the controller.
+//
+// @param sequence		Sequence number of the ping.
+// @param game_time		Game timestamp of the ping.
+// @param controller_time	Controller timestamp of the pong.
+static void bt_receiver_pong(uint8_t sequence, uint32_t game_time, uint32_t controller_time);
+
+// Forgets the sequence number of the last button press, so that the next press
+// starts the sequence again. Called whenever the controller may have
+// started counting again.
+static void bt_receiver_resync_buttons();
+
+// Handles a sequenced button press from the controller.
+//
+// @param sequence	Sequence number of the press.
+// @param state		The button state.
+static void bt_receiver_sequenced_button(uint8_t sequence, BTButtonState state);
+
+// Reads a 32-bit unsigned integer sent as 4 8-bit integers, least
+// significant first.
+//
+// @return The 32-bit integer.
+static uint32_t bt_receiver_read_uint32();
+
 // Sends a 32-bit unsigned integer over the serial port by breaking
 // it up into 4 8-bit integers.
 //
@@ -20,12 +120,28 @@ static void bt_receiver_send_uint32(uint32_t n);
 // =========== Public API ============
 // All Public APIs are documented in bt_receiver.
 
-void bt_receiver_init(BTCallbackFunctions functions) {
+void bt_receiver_init(BTCallbackFunctions functions, int cts_pin) {
 	callbacks = functions;
-	Serial3.begin(9600);
+	cts = cts_pin;
+	pinMode(cts, INPUT);
+	digitalWrite(cts, HIGH);
+	Serial3.begin(baud_rates[0]);
+	bt_receiver_negotiate_baud();
+	bt_receiver_resync_buttons();
+	bt_receiver_reset_stats();
+}
+
+long bt_receiver_baud() {
+	return baud_rates[baud_index];
+}
+
+boolean bt_receiver_clear_to_send() {
+	return digitalRead(cts) == HIGH;
 }
 
 void bt_receiver_update() {
+	bt_receiver_update_ping();
+
 	int num_bytes = Serial3.available();
 	if (num_bytes == 0) return;
 
@@ -33,17 +149,69 @@ void bt_receiver_update() {
 	if (header == 0x01 && callbacks.button) { // Button up/down command
 		if (num_bytes >= 2) {
 			Serial3.read(); // Flush header from the Serial buffer
+			controller_seen = true;
 			callbacks.button((BTButtonState)Serial3.read());
 		}
 	} else if (header == 0x02 && callbacks.toggle) {
 		Serial3.read();
+		controller_seen = true;
 		callbacks.toggle();
+	} else if (header == 0x0A) { // Pong
+		if (num_bytes >= 10) {
+			Serial3.read();
+			uint8_t sequence = Serial3.read();
+			uint32_t game_time = bt_receiver_read_uint32();
+			uint32_t controller_time = bt_receiver_read_uint32();
+			bt_receiver_pong(sequence, game_time, controller_time);
+		}
+	} else if (header == 0x0B) { // Sequenced button up/down command
+		if (num_bytes >= 3) {
+			Serial3.read();
+			uint8_t sequence = Serial3.read();
+			bt_receiver_sequenced_button(sequence, (BTButtonState)Serial3.read());
+		}
+	} else if (header == 0x07) { // Late link acknowledgement
+		if (num_bytes >= 2) {
+			Serial3.read();
+			Serial3.read();
+		}
 	} else {
 		Serial3.read();
 	}
 }
 
+void bt_receiver_get_stats(BTLinkStats *out) {
+	*out = stats;
+}
+
+void bt_receiver_reset_stats() {
+	memset(&stats, 0, sizeof(stats));
+	stats.rtt_min = UINT32_MAX;
+}
+
+void bt_receiver_print_stats(Print *out) {
+	out->print("link baud:");
+	out->print(bt_receiver_baud());
+	out->print(" pings:");
+	out->print(stats.pings_sent);
+	out->print(" lost:");
+	out->print(stats.pings_lost);
+	if (stats.pongs_received > 0) {
+		out->print(" rtt min:");
+		out->print(stats.rtt_min);
+		out->print(" avg:");
+		out->print(stats.rtt_total / stats.pongs_received);
+		out->print(" max:");
+		out->print(stats.rtt_max);
+	}
+	out->print(" buttons:");
+	out->print(stats.buttons_received);
+	out->print(" lost:");
+	out->println(stats.buttons_lost);
+}
+
 void bt_receiver_send_reset() {
+	bt_receiver_resync_buttons();
 	Serial3.write(0x03);
 }
 
@@ -59,6 +227,139 @@ void bt_receiver_send_high_score(uint32_t high_score) {
 
 // =========== Private API ============
 
+static void bt_receiver_negotiate_baud() {
+	int attempts = link_hello_attempts;
+	for (int i = num_baud_rates - 1; i > 0; i--) {
+		// Propose the rate at the initial rate.
+		boolean acked = false;
+		for (int attempt = 0; attempt < attempts && acked == false; attempt++) {
+			acked = bt_receiver_hello(i);
+		}
+		if (acked == false) {
+			// Only a bridge that hasn't been heard from yet may be left at
+			// another rate.
+			if (attempts > 1) {
+				bt_receiver_probe_baud();
+			}
+			return;
+		}
+		attempts = 1;
+
+		// Switch over and confirm that the link works at the new rate.
+		Serial3.flush();
+		Serial3.begin(baud_rates[i]);
+		if (bt_receiver_hello(i)) {
+			baud_index = i;
+			return;
+		}
+		Serial3.begin(baud_rates[0]);
+		delay(link_fallback_delay);
+	}
+}
+
+static void bt_receiver_probe_baud() {
+	for (int i = num_baud_rates - 1; i > 0; i--) {
+		Serial3.flush();
+		Serial3.begin(baud_rates[i]);
+		for (int attempt = 0; attempt < link_probe_attempts; attempt++) {
+			if (bt_receiver_hello(i)) {
+				baud_index = i;
+				return;
+			}
+		}
+	}
+	Serial3.flush();
+	Serial3.begin(baud_rates[0]);
+}
+
+static boolean bt_receiver_hello(int index) {
+	// Anything received before the hello is stale (or garbage from a rate change).
+	while (Serial3.available()) {
+		Serial3.read();
+	}
+	Serial3.write(0x06);
+	Serial3.write((uint8_t)index);
+
+	unsigned long start = millis();
+	while (millis() - start < link_reply_timeout) {
+		if (Serial3.available() < 2) continue;
+		if (Serial3.read() == 0x07 && Serial3.peek() == index) {
+			Serial3.read();
+			return true;
+		}
+	}
+	return false;
+}
+
+static void bt_receiver_update_ping() {
+	if (controller_seen == false) return;
+
+	unsigned long now = millis();
+	if (ping_pending) {
+		if (now - ping_time < ping_timeout) return;
+		ping_pending = false;
+		stats.pings_lost++;
+
+		// The controller may have disconnected and will count from the start
+		// when it comes back.
+		bt_receiver_resync_buttons();
+	}
+	if (now - ping_time < ping_interval || bt_receiver_clear_to_send() == false) return;
+
+	ping_sequence++;
+	ping_time = now;
+	ping_pending = true;
+	stats.pings_sent++;
+	Serial3.write(0x09);
+	Serial3.write(ping_sequence);
+	bt_receiver_send_uint32(micros());
+}
+
+static void bt_receiver_pong(uint8_t sequence, uint32_t game_time, uint32_t controller_time) {
+	// Answers to pings that have already timed out were counted as lost.
+	if (ping_pending == false || sequence != ping_sequence) return;
+	ping_pending = false;
+
+	uint32_t rtt = micros() - game_time;
+	stats.pongs_received++;
+	stats.rtt_min = min(stats.rtt_min, rtt);
+	stats.rtt_max = max(stats.rtt_max, rtt);
+	stats.rtt_total += rtt;
+	stats.controller_time = controller_time;
+}
+
+static void bt_receiver_sequenced_button(uint8_t sequence, BTButtonState state) {
+	controller_seen = true;
+	if (button_sequence_seen) {
+		// Sequence numbers that went back a little are late duplicates, which
+		// are dropped rather than letting an old button state through.
+		uint8_t gap = sequence - button_sequence;
+		uint8_t behind = button_sequence - sequence;
+		if (behind > 0 && behind <= button_duplicate_window) return;
+		if (gap <= button_max_gap) {
+			stats.buttons_lost += gap;
+		}
+	}
+	button_sequence_seen = true;
+	button_sequence = sequence + 1;
+	stats.buttons_received++;
+	if (callbacks.button) {
+		callbacks.button(state);
+	}
+}
+
+static void bt_receiver_resync_buttons() {
+	button_sequence_seen = false;
+}
+
+static uint32_t bt_receiver_read_uint32() {
+	uint32_t n = 0;
+	for (int i = 0; i < sizeof(uint32_t); i++) {
+		n |= (uint32_t)Serial3.read() << (8 * i);
+	}
+	return n;
+}
+
 static void bt_receiver_send_uint32(uint32_t n) {
 	for (int i = 0; i < sizeof(uint32_t); i++) {
 		Serial3.write(lowByte(n));
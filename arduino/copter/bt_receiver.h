@@ -29,6 +29,58 @@
 //
 // 6) SEND: Update high score.
 //    Byte sequence: 0x05 <32 bit integer>
+//
+// 7) SEND: Link hello, proposing a baud rate to the bridge.
+//    Byte sequence: 0x06 <8 bit baud rate index>
+//
+// 8) RECEIVE: Link acknowledge, accepting a baud rate.
+//    Byte sequence: 0x07 <8 bit baud rate index>
+//
+// 9) SEND: Ping.
+//    Byte sequence: 0x09 <8 bit sequence number> <32 bit game timestamp>
+//
+// 10) RECEIVE: Pong, answering a ping.
+//    Byte sequence: 0x0A <8 bit sequence number of the ping>
+//                   <32 bit game timestamp of the ping> <32 bit controller timestamp>
+//
+// 11) RECEIVE: Sequenced button press down or up.
+//    Byte sequence: 0x0B <8 bit sequence number> <0x01 for down, 0x00 for up>
+//
+// Game timestamps are in microseconds and controller timestamps in milliseconds,
+// both from an arbitrary starting point. Sequence numbers count up by one for
+// every message of the same kind and wrap around from 0xFF to 0x00, so that
+// missing messages can be detected. The controller may start its button
+// sequence from any number when it connects. The game picks the sequence up
+// again from the next press after the link is set up, after a game reset
+// signal, after a ping goes unanswered, and when a press is far out of
+// sequence.
+//
+// Commands 7 and 8 are exchanged with the Arduino running bt_transmitter (the
+// bridge) rather than with the controller, and are not forwarded over Bluetooth.
+//
+// ======== Link Setup ========
+//
+// The serial link to the bridge starts out at 9600 baud. At startup the game
+// sends a hello for the fastest rate in BT_BAUD_RATES. The bridge acknowledges
+// it at the current rate and then switches to the new rate, and so does the
+// game once it receives the acknowledgement. The game then repeats the hello at
+// the new rate, which the bridge acknowledges again to confirm that the link
+// works. If the confirmation doesn't arrive in time, both sides go back to 9600
+// baud and the game tries the next slower rate.
+//
+// The bridge keeps a confirmed rate until it is switched off, but the game
+// starts again at 9600 baud whenever the Mega resets (e.g. on every upload).
+// So if the bridge doesn't answer at 9600 baud, the game sends a hello for
+// each of the faster rates at that rate, and stays at the first one that the
+// bridge acknowledges. If the bridge doesn't answer at all (e.g. it isn't
+// connected), the link stays at 9600 baud.
+//
+// ======== Flow Control ========
+//
+// The bridge receives with SoftwareSerial, which loses incoming bytes while it
+// is sending. It pulls its clear-to-send line low while it is busy, and the
+// game holds back telemetry (the score) while the line is low. The line has a
+// pull-up, so a bridge that is wired without it is always clear to send.
 
 #ifndef __btreceiver_h__
 #define __btreceiver_h__
@@ -42,6 +94,11 @@ typedef enum {
 	BTButtonDown = 1
 } BTButtonState;
 
+// Baud rates that the link to the bridge can run at, from slowest to fastest.
+// A rate is identified by its index in the list. The list must match the one
+// in bt_transmitter.
+#define BT_BAUD_RATES {9600, 19200, 38400, 57600}
+
 // Definition for a callback function that accepts a BTButtonState as
 // a parameter.
 typedef void BTButtonCallback(BTButtonState state);
@@ -56,16 +113,52 @@ typedef struct {
 	BTPauseToggleCallback *toggle;
 } BTCallbackFunctions;
 
-// Initializes the Bluetooth stack.
+// Quality of the link to the controller, measured with pings and the sequence
+// numbers of button presses.
+typedef struct {
+	uint16_t pings_sent;		// Pings sent to the controller.
+	uint16_t pongs_received;	// Pings answered by the controller.
+	uint16_t pings_lost;		// Pings that timed out without an answer.
+	uint32_t rtt_min;			// Shortest round trip time, in microseconds.
+	uint32_t rtt_max;			// Longest round trip time, in microseconds.
+	uint32_t rtt_total;			// Sum of the round trip times, in microseconds.
+	uint32_t controller_time;	// Controller timestamp of the last pong.
+	uint16_t buttons_received;	// Sequenced button presses received.
+	uint16_t buttons_lost;		// Sequenced button presses that never arrived.
+} BTLinkStats;
+
+// Initializes the Bluetooth stack and negotiates the baud rate of the link to
+// the bridge. Blocks for a few hundred milliseconds if no bridge answers.
 // @param functions A struct of callback functions to be called for certain Bluetooth
 // 		  			commands received by the module.
+// @param cts_pin	Pin connected to the clear-to-send line of the bridge.
 //
-void bt_receiver_init(BTCallbackFunctions functions);
+void bt_receiver_init(BTCallbackFunctions functions, int cts_pin);
+
+// Returns the baud rate of the link to the bridge.
+long bt_receiver_baud();
+
+// Returns whether the bridge is ready to take more data. Telemetry that can
+// be sent again later should be held back while it isn't.
+boolean bt_receiver_clear_to_send();
 
 // Checks for incoming Bluetooth data and calls the appropriate callback functions
-// if necessary.
+// if necessary. Also pings the controller every so often once it has been heard from.
 void bt_receiver_update();
 
+// Returns the link quality measured since the stats were last reset.
+//
+// @param stats Pointer to the struct to copy the stats into.
+void bt_receiver_get_stats(BTLinkStats *stats);
+
+// Resets the link quality stats.
+void bt_receiver_reset_stats();
+
+// Prints the link quality stats on a single line.
+//
+// @param out The stream to print to (e.g. &Serial).
+void bt_receiver_print_stats(Print *out);
+
 // Send Bluetooth command to indicate that the game has been reset.
 void bt_receiver_send_reset();
 
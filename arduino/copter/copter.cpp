@@ -4,8 +4,21 @@
 // Created November 21, 2013
 
 #include "scene.h"
+#include "scene_config.h"
+#include "hud.h"
+#include "governor.h"
+#include "drawing_utils.h"
+#include "rng.h"
 #include "bt_receiver.h"
+#include "latency.h"
+#include "memory_stats.h"
+#include "arena.h"
+#include "eeprom_queue.h"
+#include "sd_card.h"
+#include "sd_log.h"
+#include "splash.h"
 #include "colors.h"
+#include "assets.h"
 #include <EEPROM.h>
 
 // Uncomment to use the large 5" LCD instead of 1.8"
@@ -23,22 +36,118 @@
 #ifdef USE_LARGE_LCD
 static const int TFT_CS 	= 2;
 static const int TFT_RST	= 3;
-static const g_size TFT_SIZE = {480, 272};
+static const g_size TFT_SIZE = {large_lcd_width, large_lcd_height};
 #else
 static const int TFT_CS 	= 6;
 static const int TFT_DC	= 7;
 static const int TFT_RST	= 8;
 #endif
+#ifdef SD_CARD
+static const int SD_CS		= 5;
+#endif
 
 // Buttons and Lights
 static const int BTN 		= 9;
 static const int LED 		= 4;
 
+// Clear-to-send line of the Bluetooth bridge
+static const int BT_CTS		= 22;
+
+#ifdef LATENCY_STATS
+// Held high from the arrival of an input until the display shows it, for
+// measuring latency with a scope. Set to -1 to leave it unused.
+static const int LATENCY_PROBE = 24;
+#endif
+
 // =========== Constants ============
 
 // Random EEPROM address used to store the high scores.
 static const int EEPROM_address = 254;
 
+// Bluetooth I/O here has to be limited to avoid making the game lag. Instead
+// of sending the score on every loop iteration, we rate limit it to only send
+// every X iterations to the point where it doesn't induce any noticeable
+// lag in gameplay. The limit is for a link at `score_rate_limit_baud`, and
+// scales down as the link to the bridge gets faster.
+static const int score_rate_limit = 20;
+static const long score_rate_limit_baud = 9600;
+
+// Speed of the game, in columns scrolled per tick. The game starts at the base
+// speed and speeds up by one column every `speed_up_score` points, up to
+// max_scroll_step (see scene_config.h).
+#ifdef USE_LARGE_LCD
+static const int base_scroll_step = large_base_scroll_step;
+#else
+static const int base_scroll_step = small_base_scroll_step;
+#endif
+static const uint32_t speed_up_score = 2000;
+
+// Layout of the scene on the display in use (see scene_config.h).
+#ifdef USE_LARGE_LCD
+static const int scene_spacing = large_scene_spacing;
+static const int scene_block_distance = large_scene_block_distance;
+#define GAME_MEMORY_BYTES LARGE_SCENE_MEMORY_BYTES
+#else
+static const int scene_spacing = small_scene_spacing;
+static const int scene_block_distance = small_scene_block_distance;
+#define GAME_MEMORY_BYTES SMALL_SCENE_MEMORY_BYTES
+#endif
+
+// Time that a tick should take, in microseconds, for the game to play at the
+// speed it was tuned for. Ticks that take longer shed drawing work (see
+// governor.h).
+#ifdef USE_LARGE_LCD
+static const uint32_t tick_budget_us = 33000;
+#else
+static const uint32_t tick_budget_us = 20000;
+#endif
+
+// Detail that the scene is drawn at for each level of work shed.
+static const scene_detail shed_scene_detail[governor_num_levels] = {
+	scene_detail_full,
+	scene_detail_no_animation,
+	scene_detail_no_animation,
+	scene_detail_coalesce_terrain,
+	scene_detail_drop_frames
+};
+
+// While the HUD and telemetry are deferred, the HUD is updated every this many
+// ticks and the score is sent this many times less often.
+static const int deferred_hud_ticks = 4;
+
+// Number of loop iterations before the visibility of the flashing action text
+// changes. This is used instead of delay() to allow the Bluetooth receiver to
+// update quickly during the loop without blocking it.
+//
+// Unfortunately this means that the time interval at which the switch occurs
+// will vary between processor clock speeds.
+static const long blink_switch_count = 40000;
+
+// Prints a string from assets.h straight out of flash memory.
+#define FLASH_STRING(s) ((const __FlashStringHelper *)(s))
+
+// =========== Types ============
+
+// States of the game. Each call to loop() runs a single step of the current
+// state, so the stack depth stays constant no matter how many rounds are played.
+typedef enum {
+	game_state_intro,		// Intro screen is showing, waiting for the button.
+	game_state_playing,		// A round is in progress.
+	game_state_paused,		// A round is in progress but paused by the controller.
+	game_state_game_over	// Game Over screen is showing, waiting for the button.
+} game_state;
+
+// Text that is flashed on screen until the action button is pressed.
+typedef struct {
+	const __FlashStringHelper *text;	// The text to flash, in flash memory.
+	g_point origin;		// Point at which to draw the text.
+	int size;			// The text size.
+	int lines;			// Number of lines in the text.
+	int color;			// The text color.
+	boolean visible;	// Whether the text is currently drawn.
+	long count;			// Loop iterations since the visibility last changed.
+} action_text;
+
 // =========== Global Variables ============
 
 #ifdef USE_LARGE_LCD
@@ -50,42 +159,134 @@ Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_RST);
 // State of the remotely controlled copter button.
 boolean remote_btn_state = false;
 
-// State of the remotely controlled play/pause button (true if paused).
-boolean remote_pause_state = false; 
+// Current state of the game loop.
+static game_state current_state = game_state_intro;
+
+// Random number generator for the whole game. Its state can be saved at the
+// start of a round to replay it.
+static rng game_rng;
+
+// The game scene. It is created for the first round and reset (rather than
+// freed and reallocated) for every round after that.
+static scene *game_scene = NULL;
+
+// Static memory that the scene is allocated from, so that the game state never
+// touches the heap.
+static ARENA_BUFFER(game_memory, GAME_MEMORY_BYTES);
+
+// Score of the round in progress (or the last round on the Game Over screen).
+static uint32_t score = 0;
+
+// High score read from, and persisted to, the EEPROM.
+static uint32_t high_score = 0;
+
+// Score at which the game next speeds up.
+static uint32_t next_speed_up = 0;
+
+// Number of ticks since the score was last sent over Bluetooth.
+static int score_rate = 0;
+
+// Number of ticks between sending the score over Bluetooth, for the baud
+// rate that the link to the bridge runs at.
+static int score_rate_ticks = score_rate_limit;
+
+// The in-game score display.
+static hud score_hud;
+
+// Ticks since the HUD was last updated.
+static int hud_ticks = 0;
+
+// Sheds drawing work when ticks run over budget.
+static governor tick_governor;
+
+#ifdef DRAW_STATS
+// Drawing done by the last tick, and by the heaviest tick of the round.
+static draw_stats last_tick_draw;
+static draw_stats peak_tick_draw;
+#endif
+
+#ifdef LATENCY_STATS
+// Last polled state of the hardware button, to detect presses and releases.
+static boolean hw_btn_state = false;
+#endif
+
+#ifdef SD_LOG
+// When the last tick started, for the frame times in the log.
+static uint32_t last_tick_start;
+#endif
+
+// The text currently flashing on the intro or Game Over screen.
+static action_text flash_text;
+
+// Whether the pause screen may have been drawn over the scene.
+static boolean scene_covered = false;
 
 // =========== Function Definitions ============ 
 
+// Switches the game to a new state, performing the work needed to enter it
+// (drawing the intro or Game Over screens, starting a round, etc.)
+//
+// @param new_state The state to switch to.
+static void set_game_state(game_state new_state);
+
 // Shows the introduction screen with the game title, etc.
 static void show_intro();
 
-// Runs the Copter game until the player loses.
+// Sets up the scene and game state for a new round.
+static void start_round();
+
+// Runs a single tick of the round in progress.
 //
-// @param high_score Pointer to a high score to set and write
-// to EEPROM if the player beats it.
-static void run_game(uint32_t *high_score);
+// @return Whether the copter collided, ending the round.
+static boolean update_round();
+
+// Persists and sends the final score once the player loses.
+static void end_round();
 
 // Shows the Game Over screen.
+static void show_game_over();
+
+// Draws a splash screen from the SD card.
+//
+// @param screen The screen to draw.
+// @return Whether the screen was drawn. If not, draw it as text instead.
+static boolean show_splash(splash_screen screen);
+
+// Redraws part of the splash screen showing, to erase text drawn over it.
 //
-// @param score 		The game score to show.
-// @param high_score 	Pointer to the high score to show.
-static void game_over(uint32_t score, uint32_t *high_score);
+// @param r The region to redraw.
+// @return Whether the region was redrawn. If not, clear it instead.
+static boolean restore_splash(g_rect r);
 
-// Show flashing text until the action button is pressed.
+// Starts flashing text on screen until the action button is pressed.
 //
-// @param s 		The text to flash.
+// @param s 		The text to flash, in flash memory.
 // @param p 		Point at which to draw the text.
 // @param size 		The text size.
 // @param color 	The text color.
-static void flash_action_text(const char *s, g_point p, int size, int color);
+static void flash_action_text(const __FlashStringHelper *s, g_point p, int size, int color);
+
+// Advances the flashing action text by one loop iteration.
+//
+// @return Whether the action button is pressed.
+static boolean update_action_text();
 
 // Returns whether the button is pressed (either in hardware or
 // through the Bluetooth controller)
 static boolean is_button_down();
 
+#ifdef LATENCY_STATS
+// Timestamps presses and releases of the hardware button for the latency
+// measurements. The button can only be polled, so this is done between ticks
+// as well as at the start of each one.
+static void poll_latency_button();
+#endif
+
 // Returns high score read from the EEPROM.
 static long read_EEPROM_score();
 
-// Writes a high score to the EEPROM.
+// Queues a high score to be written to the EEPROM. The write finishes in the
+// background over the next ~13ms.
 static void write_EEPROM_score(uint32_t score);
 
 // Bluetooth callbacks
@@ -96,9 +297,13 @@ void bt_toggle_pause();
 
 void setup() {
 	Serial.begin(9600);
-	randomSeed(analogRead(0));
+	arena_init(game_memory, sizeof(game_memory));
+	uint32_t seed = ((uint32_t)analogRead(0) << 16) ^ micros();
+	rng_seed(&game_rng, seed);
 	BTCallbackFunctions functions = (BTCallbackFunctions){&bt_button_press, &bt_toggle_pause};
-	bt_receiver_init(functions);
+	bt_receiver_init(functions, BT_CTS);
+	score_rate_ticks = max(1L, score_rate_limit * score_rate_limit_baud / bt_receiver_baud());
+	governor_init(&tick_governor, tick_budget_us);
 
 #ifdef USE_LARGE_LCD
 
@@ -115,95 +320,261 @@ void setup() {
 	tft.PWM1out(255);
 #else
 	tft.initR(INITR_BLACKTAB);
+#endif
+#ifdef SD_CARD
+	if (!sd_card_init(SD_CS)) {
+		Serial.println(F("No SD card"));
+	}
+#endif
+#ifdef SD_SPLASH
+#ifdef USE_LARGE_LCD
+	splash_init(splash_panel_ra8875, TFT_SIZE, TFT_CS, 0);
+#else
+	splash_init(splash_panel_st7735, (g_size){tft.width(), tft.height()}, TFT_CS, TFT_DC);
+#endif
+#endif
+#ifdef SD_LOG
+	// The seed tells the sessions apart in the log.
+	sd_log_init(seed);
 #endif
 	pinMode(LED, OUTPUT);
 	pinMode(BTN, INPUT);	
 	digitalWrite(BTN, HIGH);
+#ifdef LATENCY_STATS
+	latency_init(LATENCY_PROBE);
+#endif
 
-	uint32_t high_score = read_EEPROM_score();
+	high_score = read_EEPROM_score();
 	bt_receiver_send_high_score(high_score);
-	show_intro();
-	run_game(&high_score);
+	set_game_state(game_state_intro);
 }
 
-static void show_intro() {
-	tft.fillScreen(TFT_BLACK);
+void loop() {
+#ifdef MEMORY_STATS
+	// Sending 'm' over the serial monitor prints the memory in use.
+	if (Serial.available() > 0 && Serial.read() == 'm') {
+		memory_print(&Serial);
+	}
+#endif
+#ifdef LATENCY_STATS
+	latency_poll();
+	poll_latency_button();
+#endif
+	bt_receiver_update();
+	switch (current_state) {
+		case game_state_intro:
+		case game_state_game_over:
+			if (update_action_text()) {
+				set_game_state(game_state_playing);
+			}
+			break;
+		case game_state_playing:
+			if (update_round()) {
+				end_round();
+				set_game_state(game_state_game_over);
+			} else {
+				scene_idle(game_scene);
+#ifdef SD_LOG
+				sd_log_idle();
+#endif
+#ifdef LATENCY_STATS
+				latency_poll();
+				poll_latency_button();
+#endif
+			}
+			break;
+		case game_state_paused:
+			scene_idle(game_scene);
+			break;
+	}
+}
 
-	// Draw the game title "Copter"
-	tft.setCursor(12, 40);
-	tft.setTextSize(3);
-	tft.setTextWrap(true);
-	tft.print("Copter");
+static void set_game_state(game_state new_state) {
+	game_state old_state = current_state;
+	current_state = new_state;
+	switch (new_state) {
+		case game_state_intro:
+			show_intro();
+			break;
+		case game_state_playing:
+			// Time spent on other screens isn't part of any tick.
+			governor_restart(&tick_governor);
+
+			// Resuming from a pause continues the round in progress.
+			if (old_state != game_state_paused) {
+				start_round();
+			} else if (scene_covered) {
+				scene_redraw(game_scene);
+				hud_draw(&score_hud, score);
+			}
+			break;
+		case game_state_paused:
+			show_splash(splash_pause);
+#ifdef SD_SPLASH
+			// A card read can fail partway through the screen, after some of
+			// it has been drawn, so the scene is redrawn either way.
+			scene_covered = true;
+#endif
+			break;
+		case game_state_game_over:
+			show_game_over();
+			break;
+	}
+}
 
-	// Draw the author's names
-	tft.setCursor(12, 80);
-	tft.setTextSize(1);
-	tft.print("By Indragie Karuna\n  ratne & Jiawei Wu");
+static void show_intro() {
+	if (!show_splash(splash_intro)) {
+		tft.fillScreen(TFT_BLACK);
+
+		// Draw the logo above the title.
+		g_rect logo_frame = (g_rect){{12, 12}, {INTRO_LOGO_WIDTH, INTRO_LOGO_HEIGHT}};
+		draw_rle_image(&tft, intro_logo, INTRO_LOGO_RUNS, intro_logo_palette, logo_frame);
+
+		// Draw the game title "Copter"
+		tft.setCursor(12, 40);
+		tft.setTextSize(3);
+		tft.setTextWrap(true);
+		tft.print(FLASH_STRING(intro_title));
+
+		// Draw the author's names
+		tft.setCursor(12, 80);
+		tft.setTextSize(1);
+		tft.print(FLASH_STRING(intro_authors));
+	}
 
 	// Draw the flashing "press button" text until
 	// the user pushes the button.
-	flash_action_text("Press button to\n        begin.", (g_point){20, 120}, 1, TFT_GREEN);
+	flash_action_text(FLASH_STRING(intro_action), (g_point){20, 120}, 1, TFT_GREEN);
 }
 
-static void run_game(uint32_t *high_score) {
-	// Set up a new scene using a selected set of colors.
-	scene_colors colors;
-	colors.terrain = TFT_GREEN;
-	colors.background = TFT_BLACK;
-	colors.blocks = TFT_YELLOW;
-	colors.copter = TFT_WHITE;
+static void start_round() {
+#ifdef SD_LOG
+	// Logged before the scene uses the generator, so the round can be replayed.
+	uint32_t rng_state = game_rng.state;
+#endif
+	if (game_scene == NULL) {
+		// Set up a new scene using a selected set of colors.
+		scene_colors colors;
+		colors.terrain = TFT_GREEN;
+		colors.background = TFT_BLACK;
+		colors.blocks = TFT_YELLOW;
+		colors.copter = TFT_WHITE;
 #ifdef USE_LARGE_LCD
 
-	// We use a manual size override when testing on a large LCD because
-	// the library returns the incorrect size.
-	scene *s = scene_new(&tft, TFT_SIZE, 200, 1, 125, (g_size){10, 25}, colors);
+		// We use a manual size override when testing on a large LCD because
+		// the library returns the incorrect size.
+		g_size tft_size = TFT_SIZE;
 #else
-	g_size tft_size = (g_size){tft.width(), tft.height()};
-	scene *s = scene_new(&tft, tft_size, 100, 1, 75, (g_size){10, 25}, colors);
+		g_size tft_size = (g_size){tft.width(), tft.height()};
 #endif
+		g_size block_size = (g_size){scene_block_width, scene_block_height};
+		game_scene = scene_new(&tft, tft_size, scene_spacing, scene_max_delta,
+			scene_block_distance, block_size, colors, &game_rng);
+
+		// The score HUD sits in the top right corner, clear of the copter, and
+		// the scene leaves that region alone when redrawing the terrain.
+		g_point hud_origin = (g_point){game_scene->gen->size.width - 40, 2};
+		hud_init(&score_hud, &tft, hud_origin, TFT_WHITE, TFT_BLACK);
+		scene_set_overlay(game_scene, hud_rect(&score_hud));
+	} else {
+		// Reuse the memory from the previous round.
+		scene_reset(game_scene);
+	}
 
 	// Send the reset signal to the Bluetooth receiver to let it know that 
 	// a new game has started.
 	bt_receiver_send_reset();
-	bt_receiver_send_high_score(*high_score);
-
-	// Reset a bunch of game-related state variables back to their initial
-	// state.
-	remote_pause_state = false;
-	boolean collision = false;
-	uint32_t score = 0;
-
-	// Bluetooth I/O here has to be limited to avoid making the game lag. Instead
-	// of sending the score on every loop iteration, we rate limit it to only send
-	// every X iterations to the point where it doesn't induce any noticeable
-	// lag in gameplay.
-	const int score_rate_limit = 20;
-	int score_rate = 0;
-
-	// Continue updating the game scene until a collision has occurred.
-	while (collision == false) {
-		bt_receiver_update(); // 
-		if (remote_pause_state == false) {
-			boolean btn_down = is_button_down();
-			collision = scene_update(s, btn_down ? copter_up : copter_down);
-			digitalWrite(LED, btn_down ? HIGH : LOW); // Light up the LED according to button press.
-
-			score++;
-			score_rate++;
-			if (score_rate >= score_rate_limit) {
-				bt_receiver_send_score(score);
-				score_rate = 0;
-			}
-		}
+	bt_receiver_send_high_score(high_score);
+
+	// Reset the game-related state variables back to their initial state.
+	score = 0;
+	score_rate = 0;
+	hud_ticks = 0;
+#ifdef DRAW_STATS
+	memset(&peak_tick_draw, 0, sizeof(peak_tick_draw));
+#endif
+#ifdef LATENCY_STATS
+	hw_btn_state = digitalRead(BTN) == LOW;
+#endif
+	scene_set_speed(game_scene, base_scroll_step);
+	next_speed_up = speed_up_score;
+	hud_draw(&score_hud, score);
+#ifdef SD_LOG
+#ifdef USE_LARGE_LCD
+	sd_log_round_start(rng_state, 1, base_scroll_step);
+#else
+	sd_log_round_start(rng_state, 0, base_scroll_step);
+#endif
+	last_tick_start = micros();
+#endif
+}
+
+static boolean update_round() {
+#ifdef DRAW_STATS
+	draw_stats_reset();
+#endif
+	// Draw less this tick if the last ones ran over budget.
+	uint32_t tick_start = micros();
+	governor_level shed = governor_tick(&tick_governor, tick_start);
+	scene_set_detail(game_scene, shed_scene_detail[shed]);
+
+	boolean btn_down = is_button_down();
+	boolean collision = scene_update(game_scene, btn_down ? copter_up : copter_down);
+#ifdef LATENCY_STATS
+	latency_tick(game_scene->copter_redrawn);
+#endif
+	digitalWrite(LED, btn_down ? HIGH : LOW); // Light up the LED according to button press.
+#ifdef SD_LOG
+	// The step that moved the scene this tick, before any speed up below.
+	uint8_t tick_step = game_scene->scroll_step;
+#endif
+
+	// The score counts the distance flown, so it goes up by the number of columns
+	// scrolled, and the game speeds up as the score passes each level.
+	score += game_scene->scroll_step;
+	if (score >= next_speed_up && game_scene->scroll_step < max_scroll_step) {
+		scene_set_speed(game_scene, game_scene->scroll_step + 1);
+		next_speed_up += speed_up_score;
+	}
+	hud_ticks++;
+	if (shed < governor_level_defer_hud || hud_ticks >= deferred_hud_ticks) {
+		hud_update(&score_hud, score);
+		hud_ticks = 0;
+	}
+	// Sending the score again later does no harm, so it waits while the
+	// bridge is busy.
+	score_rate++;
+	int rate_ticks = score_rate_ticks;
+	if (shed >= governor_level_defer_hud) {
+		rate_ticks *= deferred_hud_ticks;
+	}
+	if (score_rate >= rate_ticks && bt_receiver_clear_to_send()) {
+		bt_receiver_send_score(score);
+		score_rate = 0;
+	}
+
+#ifdef DRAW_STATS
+	draw_stats_get(&last_tick_draw);
+	if (last_tick_draw.pixels_written > peak_tick_draw.pixels_written) {
+		peak_tick_draw = last_tick_draw;
 	}
-	scene_free(s);
+#endif
+#ifdef SD_LOG
+	uint8_t flags = (btn_down ? SD_LOG_TICK_BUTTON : 0) | (collision ? SD_LOG_TICK_COLLISION : 0);
+	sd_log_tick(flags, tick_step, micros() - tick_start, tick_start - last_tick_start, score);
+	last_tick_start = tick_start;
+#endif
+	return collision;
+}
 
+static void end_round() {
 	// New high scores are written to the EEPROM where they are persisted across
 	// Arduino resets. We are careful to write only when the high score has changed
-	// because the EEPROM has a limit of 100,000 write/erase cycles.
-	if (score > *high_score) {
-		*high_score = score;
-		write_EEPROM_score(*high_score);
+	// because the EEPROM has a limit of 100,000 write/erase cycles. The bytes are
+	// written by the EEPROM interrupt while the Game Over screen is showing.
+	if (score > high_score) {
+		high_score = score;
+		write_EEPROM_score(high_score);
 	}
 
 	// If the user was pressing the button when the game ended, we don't want to throw
@@ -215,32 +586,48 @@ static void run_game(uint32_t *high_score) {
 	// might not have the most up to date score at the end of the game, so that's taken
 	// care of here.
 	bt_receiver_send_score(score);
-	bt_receiver_send_high_score(*high_score);
+	bt_receiver_send_high_score(high_score);
+	bt_receiver_print_stats(&Serial);
 
-	// Show game over screen.
-	game_over(score, high_score);
+#ifdef DRAW_STATS
+	Serial.print("last tick ");
+	draw_stats_print(&Serial, &last_tick_draw);
+	Serial.print("peak tick ");
+	draw_stats_print(&Serial, &peak_tick_draw);
+#endif
+#ifdef LATENCY_STATS
+	latency_cancel();
+	latency_print(&Serial);
+#endif
+#ifdef MEMORY_STATS
+	memory_print(&Serial);
+#endif
+#ifdef SD_LOG
+	sd_log_round_end(score);
+#endif
 }
 
-static void game_over(uint32_t score, uint32_t *high_score) {
-	// Draw the Game Over title
-	tft.fillScreen(TFT_BLACK);
-	tft.setCursor(10, 40);
-	tft.setTextSize(2);
-	tft.setTextColor(TFT_RED);
-	tft.print("Game Over");
+static void show_game_over() {
+	// Draw the Game Over title, which the splash screen has built in.
+	if (!show_splash(splash_game_over)) {
+		tft.fillScreen(TFT_BLACK);
+		tft.setCursor(10, 40);
+		tft.setTextSize(2);
+		tft.setTextColor(TFT_RED);
+		tft.print(FLASH_STRING(game_over_title));
+	}
 
 	// Draw the score
 	tft.setCursor(12, 80);
 	tft.setTextSize(1);
 	tft.setTextColor(TFT_WHITE);
-	tft.print("Score: ");
+	tft.print(FLASH_STRING(game_over_score));
 	tft.print(score);
-	tft.print("\n  High Score: ");
-	tft.print(*high_score);
+	tft.print(FLASH_STRING(game_over_high_score));
+	tft.print(high_score);
 
 	// Draw the text for retry
-	flash_action_text("Press button to\n        retry.", (g_point){20, 120}, 1, TFT_GREEN);
-	run_game(high_score);
+	flash_action_text(FLASH_STRING(game_over_action), (g_point){20, 120}, 1, TFT_GREEN);
 }
 
 static boolean is_button_down() {
@@ -249,34 +636,67 @@ static boolean is_button_down() {
 	return (remote_btn_state == true) || (digitalRead(BTN) == LOW);
 }
 
-static void flash_action_text(const char *s, g_point p, int size, int color) {
-	boolean visible = false;
-	// Number of loop iterations before the visibility of the text changes.
-	// This is used instead of delay() to allow the Bluetooth receiver to update
-	// quickly during the loop without blocking it.
-	//
-	// Unfortunately this means that the time interval at which the switch occurs
-	// will vary between processor clock speeds. 
-	const long blink_switch_count = 40000;
-	long blink_current_count = blink_switch_count;
-	while (is_button_down() == false) {
-		if (++blink_current_count >= blink_switch_count) {
-			visible = !visible;
-			blink_current_count = 0;
-			if (visible) {
-				tft.setCursor(p.x, p.y);
-				tft.setTextColor(color);
-				tft.setTextSize(size);
-				tft.print(s);
-			} else {
-				tft.fillRect(p.x, p.y, tft.width() - p.x, tft.height() - p.y, TFT_BLACK);
-			}
+static boolean show_splash(splash_screen screen) {
+#ifdef SD_SPLASH
+	return splash_draw(screen);
+#else
+	return false;
+#endif
+}
+
+static boolean restore_splash(g_rect r) {
+#ifdef SD_SPLASH
+	return splash_restore(r);
+#else
+	return false;
+#endif
+}
+
+static void flash_action_text(const __FlashStringHelper *s, g_point p, int size, int color) {
+	flash_text.text = s;
+	flash_text.origin = p;
+	flash_text.size = size;
+	flash_text.lines = 1;
+	for (const char *c = (const char *)s; pgm_read_byte(c) != '\0'; c++) {
+		if (pgm_read_byte(c) == '\n') flash_text.lines++;
+	}
+	flash_text.color = color;
+	flash_text.visible = false;
+	flash_text.count = blink_switch_count;
+}
+
+static boolean update_action_text() {
+	if (is_button_down()) return true;
+
+	if (++flash_text.count >= blink_switch_count) {
+		flash_text.visible = !flash_text.visible;
+		flash_text.count = 0;
+		g_point p = flash_text.origin;
+		if (flash_text.visible) {
+			tft.setCursor(p.x, p.y);
+			tft.setTextColor(flash_text.color);
+			tft.setTextSize(flash_text.size);
+			tft.print(flash_text.text);
+		} else if (!restore_splash((g_rect){p, {tft.width() - p.x, 8 * flash_text.size * flash_text.lines}})) {
+			tft.fillRect(p.x, p.y, tft.width() - p.x, tft.height() - p.y, TFT_BLACK);
 		}
-		bt_receiver_update();
 	}
+	return false;
 }
 
+#ifdef LATENCY_STATS
+static void poll_latency_button() {
+	if (current_state != game_state_playing) return;
+	boolean down = digitalRead(BTN) == LOW;
+	if (down != hw_btn_state) {
+		hw_btn_state = down;
+		latency_input(latency_source_button);
+	}
+}
+#endif
+
 static long read_EEPROM_score() {
+	eeprom_queue_flush();
 	const int byte_count = sizeof(uint32_t);
   	uint8_t bytes[byte_count];
   	uint32_t value = 0;
@@ -293,18 +713,28 @@ static long read_EEPROM_score() {
 }
 
 static void write_EEPROM_score(uint32_t score) {
+	uint8_t bytes[sizeof(uint32_t)];
 	for (int i = 0; i < sizeof(uint32_t); i++) {
-		EEPROM.write(EEPROM_address + i, lowByte(score));
+		bytes[i] = lowByte(score);
 		score >>= 8;
 	}
+	eeprom_queue_write_block(EEPROM_address, bytes, sizeof(bytes));
 }
 
 void bt_button_press(BTButtonState state) {
-	remote_btn_state = (state == BTButtonDown) ? true : false;
+	boolean down = (state == BTButtonDown) ? true : false;
+#ifdef LATENCY_STATS
+	if (current_state == game_state_playing && down != remote_btn_state) {
+		latency_input(latency_source_bluetooth);
+	}
+#endif
+	remote_btn_state = down;
 }
 
 void bt_toggle_pause() {
-	remote_pause_state = !remote_pause_state;
+	if (current_state == game_state_playing) {
+		set_game_state(game_state_paused);
+	} else if (current_state == game_state_paused) {
+		set_game_state(game_state_playing);
+	}
 }
-
-void loop() {}
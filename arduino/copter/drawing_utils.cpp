@@ -6,6 +6,13 @@
 
 #include "drawing_utils.h"
 
+#ifdef DRAW_STATS
+static draw_stats stats;
+#define DRAW_STATS_COUNT(type, n) do { stats.type++; stats.pixels_written += (n); } while (0)
+#else
+#define DRAW_STATS_COUNT(type, n)
+#endif
+
 void draw_rect(Adafruit_GFX *tft, g_rect rect, int color) {
 	const int x = rect.origin.x;
 	const int y = rect.origin.y;
@@ -17,15 +24,104 @@ void draw_rect(Adafruit_GFX *tft, g_rect rect, int color) {
 
 	if (w_unit == true && h_unit == true) {
 		draw_pixel(tft, rect.origin, color);
-	} else if (w_unit == true) {
+		return;
+	}
+
+	if (w_unit == true) {
 		tft->drawFastVLine(x, y, h, color);
 	} else if (h_unit == true) {
 		tft->drawFastHLine(x, y, w, color);
 	} else {
 		tft->fillRect(x, y, w, h, color);
 	}
+
+	if (w_unit == true) {
+		DRAW_STATS_COUNT(vlines, h);
+	} else if (h_unit == true) {
+		DRAW_STATS_COUNT(hlines, w);
+	} else {
+		DRAW_STATS_COUNT(fills, (uint32_t)w * h);
+	}
 }
 
 void draw_pixel(Adafruit_GFX *tft, g_point point, int color) {
+	DRAW_STATS_COUNT(pixels, 1);
 	tft->drawPixel(point.x, point.y, color);
 }
+
+void draw_sprite(Adafruit_GFX *tft, const uint8_t *sprite, g_point origin, g_size size, int color) {
+	const int bands = (size.height + 7) / 8;
+	for (int x = 0; x < size.width; x++) {
+		int run_start = -1;
+		for (int y = 0; y <= size.height; y++) {
+			boolean set = false;
+			if (y < size.height) {
+				set = (pgm_read_byte(sprite + x * bands + y / 8) >> (y % 8)) & 1;
+			}
+			if (set && run_start < 0) {
+				run_start = y;
+			} else if (!set && run_start >= 0) {
+				g_rect r = (g_rect){{origin.x + x, origin.y + run_start}, {1, y - run_start}};
+				draw_rect(tft, r, color);
+				run_start = -1;
+			}
+		}
+	}
+}
+
+void draw_rle_image(Adafruit_GFX *tft, const uint8_t *runs, int num_runs, const uint16_t *palette, g_rect frame) {
+	const int width = frame.size.width;
+	int x = 0;
+	int y = 0;
+	for (int i = 0; i < num_runs; i++) {
+		int count = pgm_read_byte(runs + 2 * i);
+		const int color = pgm_read_word(palette + pgm_read_byte(runs + 2 * i + 1));
+
+		// Runs continue across rows, so split them at the end of each row and
+		// draw any whole rows in between as a single rect.
+		while (count > 0) {
+			int rows = (x == 0) ? count / width : 0;
+			g_rect r;
+			if (rows > 0) {
+				r = (g_rect){{frame.origin.x, frame.origin.y + y}, {width, rows}};
+				count -= rows * width;
+				y += rows;
+			} else {
+				int n = min(count, width - x);
+				r = (g_rect){{frame.origin.x + x, frame.origin.y + y}, {n, 1}};
+				count -= n;
+				x += n;
+				if (x == width) {
+					x = 0;
+					y++;
+				}
+			}
+			draw_rect(tft, r, color);
+		}
+	}
+}
+
+#ifdef DRAW_STATS
+
+void draw_stats_get(draw_stats *out) {
+	*out = stats;
+}
+
+void draw_stats_reset() {
+	memset(&stats, 0, sizeof(stats));
+}
+
+void draw_stats_print(Print *out, const draw_stats *st) {
+	out->print("draw px:");
+	out->print(st->pixels);
+	out->print(" v:");
+	out->print(st->vlines);
+	out->print(" h:");
+	out->print(st->hlines);
+	out->print(" fill:");
+	out->print(st->fills);
+	out->print(" total:");
+	out->println(st->pixels_written);
+}
+
+#endif
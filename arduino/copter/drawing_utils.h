@@ -4,6 +4,9 @@
 // Created November 22, 2013
 //
 // Utility functions for drawing to the display.
+//
+// Defining DRAW_STATS (see the Makefile) counts every call by type along with
+// the number of pixels written, to keep an eye on how much drawing each tick does.
 
 #ifndef __drawing_utils_h__
 #define __drawing_utils_h__
@@ -24,4 +27,53 @@ void draw_rect(Adafruit_GFX *tft, g_rect rect, int color);
 // @param color The color to use to fill the pixel.
 void draw_pixel(Adafruit_GFX *tft, g_point point, int color);
 
+// Draws the set pixels of a 1bpp sprite stored in flash, as vertical runs.
+// Clear pixels are left untouched.
+//
+// @param tft		Pointer to the TFT display struct.
+// @param sprite	The sprite data in PROGMEM, one column at a time with the
+//					top row in the least significant bit of each byte, and one
+//					byte per 8 rows (see tools/asset_compiler.py).
+// @param origin	The top left corner at which to draw the sprite.
+// @param size		The pixel size of the sprite.
+// @param color		The color to use to fill the set pixels.
+void draw_sprite(Adafruit_GFX *tft, const uint8_t *sprite, g_point origin, g_size size, int color);
+
+// Draws a run-length encoded image stored in flash.
+//
+// @param tft		Pointer to the TFT display struct.
+// @param runs		The image data in PROGMEM as (count, palette index) byte
+//					pairs, row by row (see tools/asset_compiler.py).
+// @param num_runs	The number of runs in `runs`.
+// @param palette	The colors of the image in PROGMEM.
+// @param frame		The rectangle covered by the image.
+void draw_rle_image(Adafruit_GFX *tft, const uint8_t *runs, int num_runs, const uint16_t *palette, g_rect frame);
+
+#ifdef DRAW_STATS
+
+// Counts of the drawing done since draw_stats_reset() was last called.
+typedef struct {
+	uint16_t pixels;			// Single pixels drawn.
+	uint16_t vlines;			// Vertical lines drawn.
+	uint16_t hlines;			// Horizontal lines drawn.
+	uint16_t fills;				// Filled rects drawn.
+	uint32_t pixels_written;	// Total number of pixels in everything drawn.
+} draw_stats;
+
+// Returns the counts of the drawing done since the last reset.
+//
+// @param stats Pointer to the struct to copy the counts into.
+void draw_stats_get(draw_stats *stats);
+
+// Resets all the counts to zero.
+void draw_stats_reset();
+
+// Prints the counts on a single line.
+//
+// @param out		The stream to print to (e.g. &Serial).
+// @param stats		The counts to print.
+void draw_stats_print(Print *out, const draw_stats *stats);
+
+#endif
+
 #endif
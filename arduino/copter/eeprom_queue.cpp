@@ -0,0 +1,90 @@
+// ArduinoCopter
+// eeprom_queue.cpp
+//
+// Created October 19, 2026
+//
+
+#include "eeprom_queue.h"
+
+// =========== Types ============
+
+// A byte waiting to be written.
+typedef struct {
+    uint16_t address;
+    uint8_t value;
+} eeprom_op;
+
+// =========== Global Variables ============
+
+static eeprom_op ops[EEPROM_QUEUE_SIZE];
+static uint8_t head = 0;                // Index where the next byte is queued.
+static volatile uint8_t tail = 0;       // Index of the next byte to write.
+static volatile uint8_t count = 0;      // Number of bytes in the queue.
+static volatile boolean busy = false;   // Whether the interrupt is enabled.
+
+// =========== Public API ============
+// All Public APIs are documented in eeprom_queue.h
+
+void eeprom_queue_write(int address, uint8_t value) {
+    // Wait for the interrupt to make room in the queue.
+    while (count == EEPROM_QUEUE_SIZE);
+
+    eeprom_op *op = &ops[head];
+    op->address = address;
+    op->value = value;
+    head = (head + 1) % EEPROM_QUEUE_SIZE;
+
+    uint8_t sreg = SREG;
+    cli();
+    count++;
+    if (busy == false) {
+        // The interrupt fires as soon as no write is in progress, which is
+        // straight away unless the EEPROM library has just written a byte.
+        busy = true;
+        EECR |= _BV(EERIE);
+    }
+    SREG = sreg;
+}
+
+void eeprom_queue_write_block(int address, const void *data, int length) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (int i = 0; i < length; i++) {
+        eeprom_queue_write(address + i, bytes[i]);
+    }
+}
+
+boolean eeprom_queue_busy() {
+    return busy;
+}
+
+void eeprom_queue_flush() {
+    while (busy);
+}
+
+// =========== Private API ============
+
+ISR(EE_READY_vect) {
+    while (count > 0) {
+        eeprom_op *op = &ops[tail];
+        tail = (tail + 1) % EEPROM_QUEUE_SIZE;
+        count--;
+
+        // Read the byte first and skip the write if it wouldn't change it.
+        EEAR = op->address;
+        EECR |= _BV(EERE);
+        if (EEDR == op->value) continue;
+
+        // EEPE has to be set within four cycles of EEMPE, which is why this is
+        // done with interrupts disabled. The interrupt fires again once the
+        // write has finished.
+        EEDR = op->value;
+        EECR |= _BV(EEMPE);
+        EECR |= _BV(EEPE);
+        return;
+    }
+
+    // Nothing left to write. The last write has finished, since the interrupt
+    // only fires while EEPE is clear.
+    EECR &= ~_BV(EERIE);
+    busy = false;
+}
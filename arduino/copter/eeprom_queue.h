@@ -0,0 +1,42 @@
+// ArduinoCopter
+// eeprom_queue.h
+//
+// Created October 19, 2026
+//
+// Asynchronous EEPROM writes. Each byte takes about 3.3ms to write, so instead
+// of waiting for them, bytes are queued and written one at a time by the
+// EEPROM ready interrupt while the game carries on. Bytes that already hold
+// the queued value are skipped, to save on the EEPROM's limited write cycles.
+//
+// Anything that reads the EEPROM directly (e.g. through the EEPROM library)
+// must call eeprom_queue_flush() first, or it may read stale values.
+
+#ifndef __eeprom_queue_h__
+#define __eeprom_queue_h__
+#include <Arduino.h>
+
+// Number of bytes that can be queued before eeprom_queue_write() has to wait
+// for the interrupt to drain the queue.
+#define EEPROM_QUEUE_SIZE 16
+
+// Queues a byte to be written. Blocks only if the queue is full.
+//
+// @param address   The EEPROM address to write to.
+// @param value     The byte to write.
+void eeprom_queue_write(int address, uint8_t value);
+
+// Queues consecutive bytes to be written, starting at the lowest address.
+//
+// @param address   The EEPROM address of the first byte.
+// @param data      The bytes to write. They are copied, so the buffer can be
+//                  reused as soon as this returns.
+// @param length    The number of bytes to write.
+void eeprom_queue_write_block(int address, const void *data, int length);
+
+// Returns whether queued bytes are still being written.
+boolean eeprom_queue_busy();
+
+// Waits until all of the queued bytes have been written.
+void eeprom_queue_flush();
+
+#endif
@@ -5,6 +5,7 @@
 
 #include <Arduino.h>
 #include "generator.h"
+#include "memory_stats.h"
 
 // Generates and returns a new frame.
 //
@@ -13,88 +14,291 @@
 // @return The newly created frame.
 static gen_frame gen_generate_next_frame(generator *g);
 
-// Detects whether an object inside a rectangle specified in screen
-// coordinates is colliding with the terrain boundaries.
+// Generates a new frame at the end of the look-ahead buffer, placing an obstacle
+// block once enough frames are known under it.
 //
 // @param g Pointer to the generator.
-// @param x The x coordinate of the frame in screen coordinates.
-// @param y The y coordinate of the object to test collisions for.
-// @param h The height of the object to test collisions for.
+static void gen_append_lookahead(generator *g);
+
+// Picks the origin y of an obstacle block so that it stays clear of the terrain
+// in every frame under it, and passes the generator's block check if it has one.
+//
+// @param g     Pointer to the generator.
+// @param index Look-ahead index of the first frame under the block.
+//
+// @return The origin y of the block, or -1 if the block is left out.
+static int gen_place_block(generator *g, int index);
+
+// Appends a frame to the right of the frames on screen, extending the last
+// segment if the frame continues its slope.
+//
+// @param g Pointer to the generator.
+// @param f The frame to append.
+static void gen_append_segment(generator *g, gen_frame f);
+
+// Returns a pointer to the segment at the given position in the ring buffer.
+//
+// @param g     Pointer to the generator.
+// @param index Position in the ring buffer (0 is the left most segment).
+static gen_segment * gen_segment_ptr(generator *g, size_t index);
+
+// Returns a pointer to the column at the given position in the look-ahead buffer.
 //
-// @return Boolean value indicating whether a collision was detected.
-static boolean gen_detect_frame_collision(generator *g, int x, int y, int h);
+// @param g     Pointer to the generator.
+// @param index Position in the look-ahead buffer (0 is the next frame to be popped).
+static gen_column * gen_lookahead_at(generator *g, int index);
+
+
+// =========== Constants ============
+
+// Spacing between the edges of the terrain and the obstacle blocks.
+static const int block_edge_margin = 10;
+
+// Number of positions tried for a block before it is left out.
+static const int block_attempts = 4;
+
+// Range of the length of a run of terrain with the same slope.
+static const int run_length_min = 4;
+static const int run_length_max = 16;
 
 // =========== Public API ============
 // All Public APIs are documented in generator.h.
 
-generator * gen_new(g_size size, int spacing, int max_d) {
-    generator *g = (generator *)malloc(sizeof(generator));
+generator * gen_new(g_size size, int spacing, int max_d, int blk_d, g_size blk_size, rng *random) {
+    generator *g = (generator *)MEMORY_ALLOC(memory_subsystem_generator, sizeof(generator));
+    g->random = random;
     g->size = size;
     g->spacing = spacing;
     g->max_delta = max_d;
-    g->num_frames = 0;
-    g->frames = (gen_frame *)malloc(size.width * sizeof(gen_frame));
+    g->boundary_height = ((size.height - spacing) / 2) * 2;
+    g->max_block_d = blk_d;
+    g->block_size = blk_size;
+    g->block_check = NULL;
+    g->block_check_context = NULL;
+    g->block_margin = 0;
+
+    g->max_segments = GEN_MAX_SEGMENTS(size.width);
+    g->segments = (gen_segment *)MEMORY_ALLOC(memory_subsystem_generator, g->max_segments * sizeof(gen_segment));
+    gen_reset(g);
+    return g;
+}
 
-    for (int i = 0; i < size.width; i++) {
-        g->frames[i] = gen_generate_next_frame(g);
-        g->num_frames++;
+void gen_reset(generator *g) {
+    // Start off with a flat tunnel at the "median" position, ie. equivalent
+    // sized boundaries on top and bottom. This takes no random numbers and is
+    // drawn as a few large rectangles, so a round can start right away. The
+    // look-ahead buffer is filled later on, from gen_fill_lookahead() when there
+    // is time to spare or from gen_pop_frame() when a frame is needed.
+    int half_max = g->boundary_height / 2;
+    g->segments[0] = (gen_segment){g->size.width, half_max, 0};
+    g->segment_start = 0;
+    g->num_segments = 1;
+    g->segment_offset = 0;
+    g->num_frames = g->size.width;
+    g->last_frame = (gen_frame){half_max, half_max};
+    g->run_slope = 0;
+    g->run_length = 0;
+    g->lookahead_start = 0;
+    g->lookahead_count = 0;
+    g->last_block_d = 0;
+    g->pending_block = -1;
+}
+
+void gen_pop_frame(generator *g) {
+    // Make sure that the block starting at the next frame (if any) has been placed
+    // before the frame is handed out.
+    while (g->lookahead_count <= g->block_size.width + g->block_margin) {
+        gen_append_lookahead(g);
     }
 
-    return g;
+    // Pop the left most frame, dropping its segment once all of it is off screen.
+    g->segment_offset++;
+    if (g->segment_offset == gen_segment_ptr(g, 0)->length) {
+        g->segment_start = (g->segment_start + 1) % g->max_segments;
+        g->num_segments--;
+        g->segment_offset = 0;
+    }
+
+    // Append the next frame from the look-ahead buffer to the right.
+    gen_append_segment(g, gen_lookahead_at(g, 0)->frame);
+    g->lookahead_start = (g->lookahead_start + 1) % GEN_LOOKAHEAD;
+    g->lookahead_count--;
+    if (g->pending_block > 0) g->pending_block--;
+}
+
+void gen_set_block_check(generator *g, gen_block_check check, void *context, int margin) {
+    g->block_check = check;
+    g->block_check_context = context;
+    g->block_margin = margin;
+}
+
+size_t gen_num_segments(generator *g) {
+    return g->num_segments;
 }
 
-gen_frame gen_pop_frame(generator *g, gen_frame *new_frame) {
-    // Pop the left most frame and generate a new frame to append
-    // to the end of the generator's frame list.
-    gen_frame *frames = g->frames;
-    gen_frame f = frames[0];
-    size_t len = g->num_frames;
-    for (int i = 1; i < len; i++) {
-        frames[i - 1] = frames[i];
+gen_segment gen_segment_at(generator *g, size_t index) {
+    gen_segment seg = *gen_segment_ptr(g, index);
+    if (index == 0) {
+        // Leave out the frames that have scrolled off screen.
+        seg.length -= g->segment_offset;
+        seg.top_height += seg.slope * g->segment_offset;
     }
-    gen_frame f_new = gen_generate_next_frame(g);
-    frames[len - 1] = f_new;
-    if (new_frame) *new_frame = f_new;
-    return f;
+    return seg;
+}
+
+gen_frame gen_segment_frame(generator *g, gen_segment seg, int i) {
+    int top_height = seg.top_height + seg.slope * i;
+    return (gen_frame){top_height, g->boundary_height - top_height};
 }
 
-boolean gen_detect_collision(generator *g, g_rect r) {
-    for (int i = r.origin.x; i < g_rect_maxx(r); i++) {
-        if (gen_detect_frame_collision(g, i, r.origin.y, r.size.height)) {
-            return true;
+gen_frame gen_frame_at(generator *g, int x) {
+    if (x >= (int)g->num_frames) {
+        int index = x - g->num_frames;
+        while (g->lookahead_count <= index) {
+            gen_append_lookahead(g);
         }
+        return gen_lookahead_at(g, index)->frame;
     }
-    return false;
+    for (size_t i = 0; i < g->num_segments; i++) {
+        gen_segment seg = gen_segment_at(g, i);
+        if (x < seg.length) {
+            return gen_segment_frame(g, seg, x);
+        }
+        x -= seg.length;
+    }
+    return g->last_frame;
+}
+
+int gen_fill_lookahead(generator *g, int max_count) {
+    int count = 0;
+    while (count < max_count && g->lookahead_count < GEN_LOOKAHEAD) {
+        gen_append_lookahead(g);
+        count++;
+    }
+    return count;
+}
+
+int gen_next_block(generator *g) {
+    if (g->lookahead_count == 0) return -1;
+    return gen_lookahead_at(g, 0)->block_y;
+}
+
+int gen_num_decided(generator *g) {
+    return g->pending_block >= 0 ? g->pending_block : g->lookahead_count;
+}
+
+uint8_t gen_column_mask(generator *g, int x, int y) {
+    gen_frame f = gen_frame_at(g, x);
+
+    // Rows above top_height belong to the top boundary.
+    uint8_t mask = 0;
+    int top_rows = f.top_height - y;
+    if (top_rows >= 8) {
+        return 0xFF;
+    } else if (top_rows > 0) {
+        mask = (1 << top_rows) - 1;
+    }
+
+    // Rows from height - bottom_height downwards belong to the bottom boundary.
+    int free_rows = g->size.height - f.bottom_height - y;
+    if (free_rows <= 0) {
+        return 0xFF;
+    } else if (free_rows < 8) {
+        mask |= 0xFF << free_rows;
+    }
+    return mask;
 }
 
 void gen_free(generator *g) {
-    free(g->frames);
-    free(g);
+    MEMORY_FREE(memory_subsystem_generator, g->segments, g->max_segments * sizeof(gen_segment));
+    MEMORY_FREE(memory_subsystem_generator, g, sizeof(generator));
 }
 
 // =========== Private API ============
 
 static gen_frame gen_generate_next_frame(generator *g) {
-    gen_frame f;
-    size_t len = g->num_frames;
-    if (len > 0) {
-        f = g->frames[len - 1];
-    } else {
-        // If this is the first frame in the generator, start it off at the
-        // "median" position, ie. equivalent sized boundaries on top and bottom.
-        int half_max = (g->size.height - g->spacing) / 2;
-        f.top_height = half_max;
-        f.bottom_height = half_max;
+    // The terrain is made of runs with a random slope and length, which keeps
+    // the number of segments on screen low.
+    if (g->run_length == 0) {
+        int max_d = g->max_delta;
+        g->run_slope = rng_range(g->random, -max_d, max_d + 1);
+        g->run_length = rng_range(g->random, run_length_min, run_length_max + 1);
     }
 
-    int max_d = g->max_delta;
-    int d = random(max(-f.top_height, -max_d), min(f.bottom_height, max_d) + 1);
+    // A run ends early when it runs into the edge of the region.
+    gen_frame f = g->last_frame;
+    int d = constrain(g->run_slope, -f.top_height, f.bottom_height);
+    if (d == g->run_slope) {
+        g->run_length--;
+    } else {
+        g->run_length = 0;
+    }
     f.top_height += d;
     f.bottom_height -= d;
     return f;
 }
 
-static boolean gen_detect_frame_collision(generator *g, int x, int y, int h) {
-    gen_frame f = g->frames[x];
-    return (y <= f.top_height) || ((y + h) >= (g->size.height - f.bottom_height));
+static void gen_append_lookahead(generator *g) {
+    gen_frame f = gen_generate_next_frame(g);
+    g->last_frame = f;
+
+    gen_column *c = gen_lookahead_at(g, g->lookahead_count);
+    c->frame = f;
+    c->block_y = -1;
+    g->lookahead_count++;
+
+    // If the required distance has passed, it's time for another block. Its
+    // position is picked once every frame under it has been generated.
+    if (g->last_block_d >= g->max_block_d) {
+        g->pending_block = g->lookahead_count - 1;
+        g->last_block_d = 0;
+    } else {
+        g->last_block_d++;
+    }
+    if (g->pending_block >= 0 &&
+        g->lookahead_count - g->pending_block >= g->block_size.width + g->block_margin) {
+        gen_lookahead_at(g, g->pending_block)->block_y = gen_place_block(g, g->pending_block);
+        g->pending_block = -1;
+    }
+}
+
+static int gen_place_block(generator *g, int index) {
+    // Calculate the minimum and maximum constraints for the origin from the
+    // tallest top and bottom boundaries under the block.
+    int max_top = 0;
+    int max_bottom = 0;
+    for (int i = index; i < index + g->block_size.width; i++) {
+        gen_frame f = gen_lookahead_at(g, i)->frame;
+        max_top = max(max_top, f.top_height);
+        max_bottom = max(max_bottom, f.bottom_height);
+    }
+    int min_origin = max_top + block_edge_margin;
+    int max_origin = g->size.height - max_bottom - block_edge_margin - g->block_size.height;
+    for (int attempt = 0; attempt < block_attempts; attempt++) {
+        int y = rng_range(g->random, min_origin, max_origin);
+        if (g->block_check == NULL || g->block_check(g->block_check_context, index, y)) {
+            return y;
+        }
+    }
+    return -1;
+}
+
+static void gen_append_segment(generator *g, gen_frame f) {
+    gen_segment *last = gen_segment_ptr(g, g->num_segments - 1);
+    int delta = f.top_height - (last->top_height + last->slope * (last->length - 1));
+    if (last->length == 1 || delta == last->slope) {
+        last->slope = delta;
+        last->length++;
+    } else {
+        g->num_segments++;
+        *gen_segment_ptr(g, g->num_segments - 1) = (gen_segment){1, f.top_height, 0};
+    }
+}
+
+static gen_segment * gen_segment_ptr(generator *g, size_t index) {
+    return &g->segments[(g->segment_start + index) % g->max_segments];
+}
+
+static gen_column * gen_lookahead_at(generator *g, int index) {
+    return &g->lookahead[(g->lookahead_start + index) % GEN_LOOKAHEAD];
 }
@@ -5,14 +5,27 @@
 //
 // A terrain generator for the ArduinoCopter game that generates random
 // terrains for the top and bottom edges of the tunnel. The generated 
-// terrains are created using the Arduino's randomSeed() and random()
-// functions with configurable spacing and height deltas.
+// terrains are created from a seedable `rng` with configurable spacing and
+// height deltas.
+//
+// The frames on screen are stored as a list of segments of constant slope, so
+// that walking the terrain takes time proportional to the number of changes in
+// slope rather than to the width of the display. The terrain is generated in
+// runs of a random slope and length to match.
+//
+// Frames are generated ahead of time into a look-ahead buffer, so that popping
+// a frame in the middle of a game tick only has to dequeue it. The placement of
+// obstacle blocks is decided in the look-ahead buffer as well, where the terrain
+// under the whole width of the block is already known, and where a block check
+// (see gen_set_block_check()) can see the frames past it.
 //
 
 #ifndef __generator_h__
 #define __generator_h__
 
 #include "geometry.h"
+#include "rng.h"
+#include "arena.h"
 
 // A `gen_frame` (generator frame) constitutes a single "frame" of the
 // randomly generated terrain sequence. A frame represents a section of
@@ -25,16 +38,72 @@ typedef struct {
     int bottom_height;
 } gen_frame;
 
+// A `gen_segment` is a run of neighbouring frames whose top boundary changes
+// by the same amount from one frame to the next. The bottom boundary always
+// changes by the opposite amount, so it doesn't need to be stored.
+typedef struct {
+    int length;         // Number of frames in the segment.
+    int top_height;     // Height of the top boundary in the first frame.
+    int slope;          // Change in the height of the top boundary per frame.
+} gen_segment;
+
+// Maximum number of frames generated ahead of the frames on screen. Must be
+// larger than the width of an obstacle block.
+#define GEN_LOOKAHEAD 32
+
+// Checks a position for an obstacle block before the block is placed there.
+//
+// @param context   The context passed to gen_set_block_check().
+// @param index     Look-ahead index of the first frame under the block.
+// @param y         The origin y of the block.
+//
+// @return Whether the block can be placed there.
+typedef boolean (*gen_block_check)(void *context, int index, int y);
 
+// A frame waiting in the look-ahead buffer.
 typedef struct {
-    gen_frame *frames; // Array of `gen_frame` structs
-    size_t num_frames; // The length of `frames`
-    g_size size;       // The pixel width and height of the drawing region.
-    int spacing;       // Fixed spacing between top and bottom boundaries.
-    int max_delta;     // Maximum height delta between frames.
+    gen_frame frame;   // The terrain of the frame.
+    int block_y;       // Origin y of the obstacle block starting at this frame, or -1.
+} gen_column;
+
+typedef struct {
+    gen_segment *segments;  // Ring buffer of the segments visible on screen.
+    size_t max_segments;    // The capacity of `segments`.
+    size_t segment_start;   // Index of the left most segment in `segments`.
+    size_t num_segments;    // Number of segments in `segments`.
+    int segment_offset;     // Number of frames of the left most segment that are off screen.
+    size_t num_frames;      // Number of frames on screen.
+    g_size size;            // The pixel width and height of the drawing region.
+    int spacing;            // Fixed spacing between top and bottom boundaries.
+    int max_delta;          // Maximum height delta between frames.
+    int boundary_height;    // Sum of the heights of the top and bottom boundaries.
+    rng *random;            // Random number generator used for the terrain and blocks.
+    gen_column lookahead[GEN_LOOKAHEAD]; // Ring buffer of upcoming frames.
+    uint8_t lookahead_start;    // Index of the next frame to be popped.
+    uint8_t lookahead_count;    // Number of frames in the look-ahead buffer.
+    gen_frame last_frame;   // The most recently generated frame.
+    int run_slope;          // Height delta of the run of terrain being generated.
+    int run_length;         // Number of frames left in the run of terrain being generated.
+    int max_block_d;        // Distance between obstacle blocks.
+    g_size block_size;      // Size of obstacle blocks.
+    int last_block_d;       // Distance generated since the last block was placed.
+    int pending_block;      // Look-ahead index of a block waiting to be placed, or -1.
+    gen_block_check block_check;    // Checks positions for blocks, or NULL.
+    void *block_check_context;      // Context passed to `block_check`.
+    int block_margin;       // Frames generated past the end of a block before it is placed.
 } generator;
 
-// Create a new generator and generates the first set of frames.
+// Number of segments kept by a generator for a region `width` pixels wide.
+// Every segment but the last is at least 2 frames long, and the first and last
+// ones are at least partially on screen.
+#define GEN_MAX_SEGMENTS(width) ((width) / 2 + 2)
+
+// Number of bytes that gen_new() allocates from the arena for a region `width`
+// pixels wide.
+#define GEN_MEMORY_BYTES(width) \
+    (ARENA_BYTES(sizeof(generator)) + ARENA_BYTES(GEN_MAX_SEGMENTS(width) * sizeof(gen_segment)))
+
+// Create a new generator with a flat set of frames. See gen_reset().
 //
 // @param size      g_size structure containing the pixel width and height of the
 //                  region for which the generator is creating frames for.
@@ -42,31 +111,110 @@ typedef struct {
 //                  In other words, the sum of the heights of the bottom and 
 //                  top boundaries will always be equal to height - spacing.
 // @param max_d     The maximum variation in height between one frame and the next.
+// @param blk_d     Distance between obstacle blocks.
+// @param blk_size  Size of obstacle blocks.
+// @param random    Random number generator to draw the terrain and blocks from.
 //
 // @return A pointer to the newly created `generator` struct.
 //
-generator * gen_new(g_size size, int spacing, int max_d);
+generator * gen_new(g_size size, int spacing, int max_d, int blk_d, g_size blk_size, rng *random);
+
+// Discards all of the generator's frames and replaces them with a flat tunnel
+// in the middle of the region, as if the generator had just been created. No
+// random terrain is generated until frames are popped or the look-ahead buffer
+// is filled. No memory is reallocated.
+//
+// @param g Pointer to the generator.
+void gen_reset(generator *g);
+
+// Pops the first frame in the generator. Appends the next frame from the
+// look-ahead buffer to the end of the generator's frames in order to replace
+// the one that was popped. Frames are only generated here if the look-ahead
+// buffer is running too low to place an obstacle block.
+//
+// @param g         Pointer to the generator.
+void gen_pop_frame(generator *g);
+
+// Sets a function to check each position picked for an obstacle block before
+// the block is placed there. A few positions are tried for each block, and the
+// block is left out if none of them pass.
+//
+// @param g         Pointer to the generator.
+// @param check     The function, or NULL to place blocks without checking them.
+// @param context   Passed to `check`.
+// @param margin    Number of frames past the end of a block that have to be
+//                  generated before `check` is called for it. The width of a
+//                  block plus the margin must be less than GEN_LOOKAHEAD.
+void gen_set_block_check(generator *g, gen_block_check check, void *context, int margin);
+
+// Returns the number of segments that make up the frames on screen.
+//
+// @param g Pointer to the generator.
+size_t gen_num_segments(generator *g);
+
+// Returns a segment of the frames on screen. Segments are ordered from left to
+// right and the first segment always starts at x = 0.
+//
+// @param g     Pointer to the generator.
+// @param index Index of the segment, less than gen_num_segments().
+//
+// @return The segment.
+gen_segment gen_segment_at(generator *g, size_t index);
+
+// Returns a frame of a segment.
+//
+// @param g     Pointer to the generator.
+// @param seg   The segment.
+// @param i     Index of the frame within the segment.
+//
+// @return The frame.
+gen_frame gen_segment_frame(generator *g, gen_segment seg, int i);
+
+// Returns the frame at an x coordinate. Frames past the right edge of the region
+// are read from the look-ahead buffer, which is filled first if needed. Finding
+// a frame on screen takes time proportional to the number of segments before it.
+//
+// @param g Pointer to the generator.
+// @param x The x coordinate of the frame, less than the width of the region
+//          plus GEN_LOOKAHEAD.
+//
+// @return The frame.
+gen_frame gen_frame_at(generator *g, int x);
 
-// Pops the first frame in the generator and returns it. Generates a new frame
-// and appends it to the end of the generator's frames list in order to replace
-// the one that was popped.
+// Generates frames into the look-ahead buffer until it is full or the given
+// number of frames have been generated. Call this when there is time to spare
+// so that gen_pop_frame() doesn't have to generate frames itself.
 //
 // @param g         Pointer to the generator.
-// @param new_frame Pointer to be set to the newly created frame (appended to right).
+// @param max_count The maximum number of frames to generate.
+//
+// @return The number of frames generated.
+int gen_fill_lookahead(generator *g, int max_count);
+
+// Returns where to place an obstacle block that starts at the frame that the
+// next call to gen_pop_frame() will append.
 //
-// @return The popped generator frame.
-gen_frame gen_pop_frame(generator *g, gen_frame *new_frame);
+// @param g Pointer to the generator.
+//
+// @return The origin y of the block, or -1 if no block starts at the next frame.
+int gen_next_block(generator *g);
+
+// Returns how many frames of the look-ahead buffer have had their obstacle
+// blocks decided, i.e. the frames before the next block that is still waiting
+// for the frames under it to be generated.
+//
+// @param g Pointer to the generator.
+int gen_num_decided(generator *g);
 
-// Detects a collision between an object located in an arbitrary rectangle and
-// the top or bottom boundaries of the terrain. 
+// Returns which pixels of a column are covered by the top or bottom terrain,
+// as a mask of 8 rows. Rows above or below the region count as covered.
 //
 // @param g Pointer to the generator.
-// @param r The rectangle for which to test collisions for. The origin of the
-//          is relative to the screen coordinates, meaning that the origin {0,0}
-//          is located on the top left corner of the region.
+// @param x The x coordinate of the column in screen coordinates.
+// @param y The y coordinate of the first row of the mask.
 //
-// @return  true if a collision occurred, false otherwise.
-boolean gen_detect_collision(generator *g, g_rect r);
+// @return  A mask where bit n is set if the pixel at row y + n is terrain.
+uint8_t gen_column_mask(generator *g, int x, int y);
 
 // Free memory associated wtih a generator.
 //
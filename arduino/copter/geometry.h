@@ -4,45 +4,95 @@
 // Created November 19, 2013
 //
 // Definitions for some basic geometry structures.
+//
+// The structures are templates on their coordinate type so that each use can
+// pick the smallest type that fits, and all of the functions are defined here
+// so that they are inlined (and constexpr when the compiler supports C++11).
 
 #ifndef __geometry_h__
 #define __geometry_h__
 #include <Arduino.h>
 
-typedef struct {
-    int x;
-    int y;
-} g_point;
+#if __cplusplus >= 201103L
+#define G_CONSTEXPR constexpr
+#else
+#define G_CONSTEXPR inline
+#endif
+
+template <typename T>
+struct g_point_t {
+    T x;
+    T y;
+};
+
+template <typename T>
+struct g_size_t {
+    T width;
+    T height;
+};
+
+template <typename T>
+struct g_rect_t {
+    g_point_t<T> origin;
+    g_size_t<T> size;
+};
 
-typedef struct {
-    int width;
-    int height;
-} g_size;
+// Type of display coordinates. 16 bits covers both displays (up to 480x272) as
+// well as the negative coordinates of blocks scrolling off the left edge. This is
+// the same size as an `int` on AVR, so arithmetic on it doesn't need to be widened.
+typedef int16_t g_coord;
 
-typedef struct {
-    g_point origin;
-    g_size size;
-} g_rect;
+// Type of coordinates relative to the origin of a small sprite.
+typedef int8_t g_sprite_coord;
+
+typedef g_point_t<g_coord> g_point;
+typedef g_size_t<g_coord> g_size;
+typedef g_rect_t<g_coord> g_rect;
+
+typedef g_point_t<g_sprite_coord> g_sprite_point;
 
 // Calculates the maximum Y-coordinate of the given rectangle
 // (r.origin.y + r.size.height)
 //
 // @param r The rect for which to calculate the max Y.
 // @return The max Y value.
-int g_rect_maxy(g_rect r);
+template <typename T>
+G_CONSTEXPR T g_rect_maxy(g_rect_t<T> r) {
+    return r.origin.y + r.size.height;
+}
 
 // Calculates the maxium X-coordinate of the given rectangle
 // (r.origin.x + r.size.width)
 //
 // @param r The rect for which to calculate the max X.
 // @return The max X value.
-int g_rect_maxx(g_rect r);
+template <typename T>
+G_CONSTEXPR T g_rect_maxx(g_rect_t<T> r) {
+    return r.origin.x + r.size.width;
+}
 
 // Determines whether two rectangles intersect each other.
 //
 // @param r1 The first rectangle.
 // @param r2 The second rectangle.
 // @return Whether r1 and r2 intersect.
-boolean g_rect_intersects(g_rect r1, g_rect r2);
+template <typename T>
+G_CONSTEXPR bool g_rect_intersects(g_rect_t<T> r1, g_rect_t<T> r2) {
+    return !(g_rect_maxx(r1) <= r2.origin.x ||
+             g_rect_maxx(r2) <= r1.origin.x ||
+             g_rect_maxy(r1) <= r2.origin.y ||
+             g_rect_maxy(r2) <= r1.origin.y);
+}
+
+// Determines whether a point lies inside a rectangle.
+//
+// @param r The rectangle.
+// @param p The point.
+// @return Whether p is inside r.
+template <typename T>
+G_CONSTEXPR bool g_rect_contains_point(g_rect_t<T> r, g_point_t<T> p) {
+    return p.x >= r.origin.x && p.x < g_rect_maxx(r) &&
+           p.y >= r.origin.y && p.y < g_rect_maxy(r);
+}
 
 #endif
@@ -0,0 +1,63 @@
+// ArduinoCopter
+// governor.cpp
+//
+// Created October 19, 2026
+//
+
+#include "governor.h"
+
+// =========== Constants ============
+
+// Each tick moves the average an eighth of the way to its time, so a single
+// slow tick (e.g. one that checks an obstacle block) isn't enough to shed work.
+static const uint8_t average_shift = 3;
+
+// Ticks in a row over budget before a level is shed.
+static const uint8_t shed_ticks = 16;
+
+// Ticks in a row under `restore_percent` of the budget before a level is restored.
+static const uint8_t restore_ticks = 120;
+static const uint8_t restore_percent = 75;
+
+// =========== Public API ============
+// All Public APIs are documented in governor.h
+
+void governor_init(governor *g, uint32_t budget) {
+    g->budget = budget;
+    g->average = budget;
+    g->timing = false;
+    g->over = 0;
+    g->under = 0;
+    g->level = governor_level_full;
+}
+
+void governor_restart(governor *g) {
+    g->timing = false;
+}
+
+governor_level governor_tick(governor *g, uint32_t now) {
+    if (g->timing) {
+        uint32_t elapsed = now - g->last_start;
+        g->average = g->average - (g->average >> average_shift) + (elapsed >> average_shift);
+
+        if (g->average > g->budget) {
+            g->under = 0;
+            if (++g->over >= shed_ticks && g->level < governor_num_levels - 1) {
+                g->level = (governor_level)(g->level + 1);
+                g->over = 0;
+            }
+        } else if (g->average < g->budget / 100 * restore_percent) {
+            g->over = 0;
+            if (++g->under >= restore_ticks && g->level > governor_level_full) {
+                g->level = (governor_level)(g->level - 1);
+                g->under = 0;
+            }
+        } else {
+            g->over = 0;
+            g->under = 0;
+        }
+    }
+    g->last_start = now;
+    g->timing = true;
+    return g->level;
+}
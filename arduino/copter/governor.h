@@ -0,0 +1,65 @@
+// ArduinoCopter
+// governor.h
+//
+// Created October 19, 2026
+//
+// Frame-budget governor. The game has no fixed tick rate: each tick runs as
+// soon as the last one is done, so a tick that runs long (a burst of Bluetooth
+// input, a stretch of sloped terrain, the slower large display) slows the game
+// down. The governor measures the time from the start of one tick to the start
+// of the next, and when the ticks run over budget it sheds work a level at a
+// time, in the order of `governor_level`. The game keeps ticking at every level;
+// only what is drawn and sent changes.
+//
+// A level is shed once the average tick has been over budget for a few ticks in
+// a row, and restored once it has been well under budget for a couple of
+// seconds, so that the levels don't flicker back and forth.
+
+#ifndef __governor_h__
+#define __governor_h__
+#include <Arduino.h>
+
+// Levels of work shed by the governor. Each level also sheds the work of the
+// levels before it.
+typedef enum {
+    governor_level_full = 0,            // Nothing is shed.
+    governor_level_no_animation,        // The copter's blade stops spinning.
+    governor_level_defer_hud,           // The score and telemetry are sent less often.
+    governor_level_coalesce_terrain,    // The terrain is drawn every other tick.
+    governor_level_drop_frames,         // Nothing is drawn every other tick.
+    governor_num_levels
+} governor_level;
+
+typedef struct {
+    uint32_t budget;        // Time that a tick should take, in microseconds.
+    uint32_t average;       // Running average of the tick time, in microseconds.
+    uint32_t last_start;    // When the last tick started.
+    boolean timing;         // Whether `last_start` is the start of the last tick.
+    uint8_t over;           // Ticks in a row that the average has been over budget.
+    uint8_t under;          // Ticks in a row that the average has been well under budget.
+    governor_level level;   // Work currently being shed.
+} governor;
+
+// Sets up a governor with nothing shed.
+//
+// @param g         Pointer to the governor.
+// @param budget    Time that a tick should take, in microseconds.
+void governor_init(governor *g, uint32_t budget);
+
+// Forgets when the last tick started, so that time spent outside of the game
+// (e.g. on the pause screen) isn't counted against the next tick. The level is
+// kept.
+//
+// @param g Pointer to the governor.
+void governor_restart(governor *g);
+
+// Measures the tick that just ended and returns the work to shed in the next.
+// Call at the start of every tick.
+//
+// @param g     Pointer to the governor.
+// @param now   The time, from micros().
+//
+// @return The level of work to shed.
+governor_level governor_tick(governor *g, uint32_t now);
+
+#endif
@@ -5,64 +5,45 @@
 //
 
 #include "helicopter.h"
-#include "drawing_utils.h"
-
-// =========== Function Declarations ============
-
-// Draw a copter pixel adjusted for the current copter origin.
-//
-// @param tft       Pointer to the TFT in which to draw the copter.
-// @param origin	The origin of the helicopter sprite.
-// @param p         The point of the pixel to draw.
-// @param color     The color to fill the pixel with.
-static void helicopter_draw_pixel(Adafruit_GFX *tft, g_point origin, g_point p, int color);
+#include "assets.h"
 
 // =========== Constants ============
 
 // Pixel size of the copter.
-const g_size helicopter_size = {11, 6};
+const g_size helicopter_size = {HELICOPTER_BODY_WIDTH, HELICOPTER_BODY_HEIGHT};
 
-// Array of pixels to use for drawing the copter body at an assumed
-// origin of {0, 0}
-static const g_point body_pixels[] =  {{7, 1},  {2, 2}, {6, 2}, {7, 2}, {8, 2}, {1, 3}, {2, 3}, {3, 3}, {4, 3}, {5, 3}, {6, 3}, {7, 3}, {8, 3}, {9, 3}, {2, 4}, {5, 4}, {6, 4}, {7, 4}, {8, 4}, {9, 4}, {6, 5}, {7, 5}, {8, 5}};
+// Tenths of a pixel that the helicopter moves for each level of gravity
+// (downwards) and boost (upwards).
+static const int gravity_tenths = 6;
+static const int boost_tenths = 5;
 
-// Start and end X positions of the copter blade (used for animating the blade)
-static const g_point blade_start = {4, 0};
-static const g_point blade_end = {10, 0};
-
-// The number of frames before the direction of the blade switches when
-// the copter is animating.
-static const int animation_frame_count = 1;
+// Half of the blade drawn in each animation frame.
+static const uint8_t * const helicopter_blades[HELICOPTER_NUM_FRAMES] = {
+    helicopter_blade_left,
+    helicopter_blade_right
+};
 
 // =========== Public API ============
 // All Public APIs are documented in helicopter.h
 
-void helicopter_draw(Adafruit_GFX *tft, g_point origin, int color) {
-    int num_pixels = sizeof(body_pixels) / sizeof(g_point);
-    for (int i = 0; i < num_pixels; i++) {
-        helicopter_draw_pixel(tft, origin, body_pixels[i], color);
-    }
+int helicopter_dy(int gravity, int boost) {
+    // Fractions of a pixel round towards the top of the screen.
+    int tenths = gravity * gravity_tenths - boost * boost_tenths;
+    return tenths >= 0 ? tenths / 10 : -((9 - tenths) / 10);
+}
 
-    const int half_blade = (blade_end.x - blade_start.x) / 2;
-    const int blade_y = blade_start.y;
-    static int current_frame_count = 0;
-    static boolean left_blade = true;
+uint8_t helicopter_frame_mask(int frame, int column) {
+    if (column < 0 || column >= helicopter_size.width) return 0;
 
-    if (++current_frame_count >= animation_frame_count) {
-        current_frame_count = 0;
-        left_blade = !left_blade;
-    }
-    int start_x = blade_start.x;
-    if (left_blade == false) {
-        start_x += half_blade;
-    }
-    for (int i = start_x; i < (start_x + half_blade + 1); i++) {
-        helicopter_draw_pixel(tft, origin, (g_point){i, blade_y}, color);
-    }
+    // Each blade sprite is a single row, so its column bytes line up with the
+    // top row of the body.
+    return pgm_read_byte(helicopter_body + column) | pgm_read_byte(helicopter_blades[frame] + column);
 }
 
-static void helicopter_draw_pixel(Adafruit_GFX *tft, g_point origin, g_point p, int color) {
-    p.x += origin.x;
-    p.y += origin.y;
-    draw_pixel(tft, p, color);
+uint8_t helicopter_mask(int column) {
+    uint8_t mask = 0;
+    for (int frame = 0; frame < HELICOPTER_NUM_FRAMES; frame++) {
+        mask |= helicopter_frame_mask(frame, column);
+    }
+    return mask;
 }
@@ -7,16 +7,42 @@
 #ifndef __helicopter_h__
 #define __helicopter_h__
 
-#include <Adafruit_GFX.h>
+#include <Arduino.h>
 #include "geometry.h"
 
 // The pixel size of the helicopter.
 extern const g_size helicopter_size;
 
-// Draws the helicopter sprite.
+// Returns the pixel mask of a column of the helicopter, covering every pixel
+// that can be drawn in either position of the blade. Bit n of the mask is set
+// if the pixel in row n of the column is part of the helicopter.
 //
-// @param origin 	The origin point at which to draw the helicopter.
-// @param color		The color used to fill the helicopter.
-void helicopter_draw(Adafruit_GFX *tft, g_point origin, int color);
+// @param column    The column, from 0 to helicopter_size.width - 1.
+uint8_t helicopter_mask(int column);
+
+// Highest boost level of the helicopter. Each update raises the boost by one
+// level while the helicopter is moving up, and lowers it by one otherwise.
+#define HELICOPTER_MAX_BOOST 10
+
+// Highest gravity level of the helicopter. Gravity builds up by one level with
+// each update until it reaches this level.
+#define HELICOPTER_MAX_GRAVITY 5
+
+// Returns how many pixels the helicopter moves down in an update, which is
+// negative when it moves up.
+//
+// @param gravity   The gravity level, from 0 to HELICOPTER_MAX_GRAVITY.
+// @param boost     The boost level, from 0 to HELICOPTER_MAX_BOOST.
+int helicopter_dy(int gravity, int boost);
+
+// Number of animation frames of the helicopter, one for each half of the blade.
+#define HELICOPTER_NUM_FRAMES 2
+
+// Returns the pixel mask of a column of the helicopter as drawn in one frame of
+// its animation, laid out like helicopter_mask().
+//
+// @param frame     The animation frame, from 0 to HELICOPTER_NUM_FRAMES - 1.
+// @param column    The column. Columns outside the helicopter are empty.
+uint8_t helicopter_frame_mask(int frame, int column);
 
 #endif
@@ -0,0 +1,160 @@
+// ArduinoCopter
+// hud.cpp
+//
+// Created October 19, 2026
+//
+
+#include "hud.h"
+#include "drawing_utils.h"
+#include "assets.h"
+
+// =========== Function Declarations ============
+
+// Converts a value into the glyphs for each digit. Leading zeros are blank.
+//
+// @param value     The value to convert.
+// @param digits    Array of HUD_NUM_DIGITS glyphs to fill, most significant first.
+static void hud_value_digits(uint32_t value, uint8_t *digits);
+
+// Adds one to the value represented by an array of glyphs.
+//
+// @param digits    Array of HUD_NUM_DIGITS glyphs to update, most significant first.
+static void hud_increment_digits(uint8_t *digits);
+
+// Redraws the digits that differ from the ones currently on screen.
+//
+// @param h         Pointer to the `hud`.
+// @param digits    Array of HUD_NUM_DIGITS glyphs to show, most significant first.
+static void hud_show_digits(hud *h, const uint8_t *digits);
+
+// Redraws the pixels that differ between two glyphs.
+//
+// @param h         Pointer to the `hud`.
+// @param position  Index of the digit on screen.
+// @param old_glyph The glyph currently drawn at `position`.
+// @param new_glyph The glyph to draw.
+static void hud_draw_glyph(hud *h, int position, uint8_t old_glyph, uint8_t new_glyph);
+
+// =========== Constants ============
+
+// Spacing between glyphs.
+static const int glyph_advance = HUD_GLYPHS_WIDTH + 1;
+
+// Largest increase in value that is applied by incrementing the digits on
+// screen rather than converting the value from scratch.
+static const uint8_t hud_max_increments = 8;
+
+// =========== Public API ============
+// All Public APIs are documented in hud.h
+
+void hud_init(hud *h, Adafruit_GFX *tft, g_point origin, int color, int background) {
+    h->tft = tft;
+    h->origin = origin;
+    h->color = color;
+    h->background = background;
+    h->value = 0;
+    for (int i = 0; i < HUD_NUM_DIGITS; i++) {
+        h->digits[i] = HUD_GLYPHS_BLANK;
+    }
+}
+
+g_rect hud_rect(hud *h) {
+    g_point origin = (g_point){h->origin.x - 1, h->origin.y - 1};
+    g_size size = (g_size){HUD_NUM_DIGITS * glyph_advance + 1, HUD_GLYPHS_HEIGHT + 2};
+    return (g_rect){origin, size};
+}
+
+void hud_draw(hud *h, uint32_t value) {
+    value = min(value, HUD_MAX_VALUE);
+    draw_rect(h->tft, hud_rect(h), h->background);
+    for (int i = 0; i < HUD_NUM_DIGITS; i++) {
+        h->digits[i] = HUD_GLYPHS_BLANK;
+    }
+
+    uint8_t digits[HUD_NUM_DIGITS];
+    hud_value_digits(value, digits);
+    hud_show_digits(h, digits);
+    h->value = value;
+}
+
+void hud_update(hud *h, uint32_t value) {
+    // Clamping also keeps the increments below from carrying out of the top
+    // digit.
+    value = min(value, HUD_MAX_VALUE);
+    if (value == h->value) return;
+
+    uint8_t digits[HUD_NUM_DIGITS];
+    uint32_t increase = value - h->value;
+    if (value > h->value && increase <= hud_max_increments) {
+        // The score goes up by a few points every tick, so the common case is a
+        // decimal increment of the digits on screen, which avoids 32-bit divisions.
+        memcpy(digits, h->digits, HUD_NUM_DIGITS);
+        for (uint8_t i = 0; i < increase; i++) {
+            hud_increment_digits(digits);
+        }
+    } else {
+        hud_value_digits(value, digits);
+    }
+    hud_show_digits(h, digits);
+    h->value = value;
+}
+
+// =========== Private API ============
+
+static void hud_value_digits(uint32_t value, uint8_t *digits) {
+    for (int i = HUD_NUM_DIGITS - 1; i >= 0; i--) {
+        digits[i] = value % 10;
+        value /= 10;
+    }
+    for (int i = 0; i < HUD_NUM_DIGITS - 1 && digits[i] == 0; i++) {
+        digits[i] = HUD_GLYPHS_BLANK;
+    }
+}
+
+static void hud_increment_digits(uint8_t *digits) {
+    for (int i = HUD_NUM_DIGITS - 1; i >= 0; i--) {
+        uint8_t d = (digits[i] == HUD_GLYPHS_BLANK) ? 0 : digits[i];
+        if (d < 9) {
+            digits[i] = d + 1;
+            return;
+        }
+        digits[i] = 0;
+    }
+}
+
+static void hud_show_digits(hud *h, const uint8_t *digits) {
+    for (int i = 0; i < HUD_NUM_DIGITS; i++) {
+        if (digits[i] != h->digits[i]) {
+            hud_draw_glyph(h, i, h->digits[i], digits[i]);
+            h->digits[i] = digits[i];
+        }
+    }
+}
+
+static void hud_draw_glyph(hud *h, int position, uint8_t old_glyph, uint8_t new_glyph) {
+    const int x = h->origin.x + position * glyph_advance;
+    for (int col = 0; col < HUD_GLYPHS_WIDTH; col++) {
+        uint8_t new_bits = pgm_read_byte(&hud_glyphs[new_glyph][col]);
+        uint8_t changed = pgm_read_byte(&hud_glyphs[old_glyph][col]) ^ new_bits;
+
+        // Draw each vertical run of changed pixels that share a color.
+        int row = 0;
+        while (changed) {
+            if ((changed & 1) == 0) {
+                changed >>= 1;
+                new_bits >>= 1;
+                row++;
+                continue;
+            }
+            boolean on = new_bits & 1;
+            int start = row;
+            while ((changed & 1) && (boolean)(new_bits & 1) == on) {
+                changed >>= 1;
+                new_bits >>= 1;
+                row++;
+            }
+            g_rect r = (g_rect){{x + col, h->origin.y + start}, {1, row - start}};
+            draw_rect(h->tft, r, on ? h->color : h->background);
+        }
+    }
+}
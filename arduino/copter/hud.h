@@ -0,0 +1,58 @@
+// ArduinoCopter
+// hud.h
+//
+// Created October 19, 2026
+//
+// In-game score display. Digits are drawn from the pre-rasterized 5x7 glyphs in
+// assets/hud_glyphs.txt and only the digits that changed since the last update
+// are redrawn, so the score can be kept on screen every tick for very little cost.
+
+#ifndef __hud_h__
+#define __hud_h__
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include "geometry.h"
+
+// Number of score digits shown by the HUD.
+#define HUD_NUM_DIGITS 6
+
+// Largest value that the HUD shows. Larger values are shown as this.
+#define HUD_MAX_VALUE 999999UL
+
+typedef struct {
+    Adafruit_GFX *tft;              // Display being drawn into.
+    g_point origin;                 // Top left corner of the first digit.
+    int color;                      // Color of the digits.
+    int background;                 // Color behind the digits.
+    uint32_t value;                 // The value currently shown.
+    uint8_t digits[HUD_NUM_DIGITS]; // Glyphs currently drawn, most significant first.
+} hud;
+
+// Sets up a HUD. Nothing is drawn until hud_draw() is called.
+//
+// @param h             Pointer to the `hud` to set up.
+// @param tft           Pointer to the TFT display to draw into.
+// @param origin        Top left corner of the HUD.
+// @param color         Color of the digits.
+// @param background    Color behind the digits.
+void hud_init(hud *h, Adafruit_GFX *tft, g_point origin, int color, int background);
+
+// Returns the region of the display covered by the HUD, including a 1 pixel
+// margin around the digits. Nothing else should draw into this region.
+//
+// @param h Pointer to the `hud`.
+g_rect hud_rect(hud *h);
+
+// Clears the HUD region and draws the given value in full.
+//
+// @param h     Pointer to the `hud` to draw.
+// @param value The value to show.
+void hud_draw(hud *h, uint32_t value);
+
+// Shows a new value, redrawing only the pixels of digits that changed.
+//
+// @param h     Pointer to the `hud` to update.
+// @param value The value to show.
+void hud_update(hud *h, uint32_t value);
+
+#endif
@@ -0,0 +1,148 @@
+// ArduinoCopter
+// latency.cpp
+//
+// Created October 19, 2026
+//
+
+#include "latency.h"
+
+#ifdef LATENCY_STATS
+
+// =========== Types ============
+
+// Progress of the sample for an input source.
+typedef enum {
+    latency_stage_none,     // No input is waiting to be shown.
+    latency_stage_input,    // An input has arrived but no tick has redrawn the copter since.
+    latency_stage_drawn     // A tick has redrawn the copter and is being sent to the display.
+} latency_stage;
+
+typedef struct {
+    latency_stage stage;        // Progress of the sample.
+    uint32_t input_time;        // micros() at the arrival of the input.
+    latency_histogram hist;     // Completed samples.
+} latency_state;
+
+// =========== Function Declarations ============
+
+// Adds a sample to a histogram.
+//
+// @param hist      Pointer to the histogram.
+// @param latency   The sample, in microseconds.
+static void latency_record(latency_histogram *hist, uint32_t latency);
+
+// Updates the probe pin to show whether any sample is in progress.
+static void latency_update_probe();
+
+// =========== Global Variables ============
+
+static latency_state sources[latency_num_sources];
+static int probe = -1;
+
+// Names of the input sources, as printed by latency_print().
+static const char * const source_names[latency_num_sources] = {"button", "bt"};
+
+// =========== Public API ============
+// All Public APIs are documented in latency.h
+
+void latency_init(int probe_pin) {
+    memset(sources, 0, sizeof(sources));
+    probe = probe_pin;
+    if (probe >= 0) {
+        pinMode(probe, OUTPUT);
+        digitalWrite(probe, LOW);
+    }
+}
+
+void latency_input(latency_source source) {
+    latency_state *st = &sources[source];
+    if (st->stage != latency_stage_none) return;
+    st->stage = latency_stage_input;
+    st->input_time = micros();
+    latency_update_probe();
+}
+
+void latency_tick(boolean copter_redrawn) {
+    if (!copter_redrawn) return;
+    for (int i = 0; i < latency_num_sources; i++) {
+        if (sources[i].stage == latency_stage_input) {
+            sources[i].stage = latency_stage_drawn;
+        }
+    }
+}
+
+void latency_poll() {
+    uint32_t now = micros();
+    for (int i = 0; i < latency_num_sources; i++) {
+        latency_state *st = &sources[i];
+        if (st->stage == latency_stage_drawn) {
+            latency_record(&st->hist, now - st->input_time);
+            st->stage = latency_stage_none;
+        }
+    }
+    latency_update_probe();
+}
+
+void latency_cancel() {
+    for (int i = 0; i < latency_num_sources; i++) {
+        sources[i].stage = latency_stage_none;
+    }
+    latency_update_probe();
+}
+
+void latency_get(latency_source source, latency_histogram *hist) {
+    *hist = sources[source].hist;
+}
+
+void latency_print(Print *out) {
+    for (int i = 0; i < latency_num_sources; i++) {
+        const latency_histogram *hist = &sources[i].hist;
+        out->print("latency ");
+        out->print(source_names[i]);
+        out->print(" n:");
+        out->print(hist->count);
+        if (hist->count > 0) {
+            out->print(" avg:");
+            out->print(hist->total / hist->count);
+            out->print(" max:");
+            out->print(hist->max);
+        }
+        out->println(" us");
+
+        for (int b = 0; b < LATENCY_NUM_BUCKETS; b++) {
+            if (hist->buckets[b] == 0) continue;
+            out->print(" ");
+            out->print(b == 0 ? 0UL : (1UL << b));
+            out->print(":");
+            out->print(hist->buckets[b]);
+        }
+        out->println();
+    }
+}
+
+// =========== Private API ============
+
+static void latency_record(latency_histogram *hist, uint32_t latency) {
+    int bucket = 0;
+    for (uint32_t v = latency >> 1; v != 0 && bucket < LATENCY_NUM_BUCKETS - 1; v >>= 1) {
+        bucket++;
+    }
+
+    // Counts saturate rather than wrap around over a long session.
+    if (hist->count == UINT16_MAX || hist->buckets[bucket] == UINT16_MAX) return;
+    hist->buckets[bucket]++;
+    hist->count++;
+    hist->total += latency;
+    hist->max = max(hist->max, latency);
+}
+
+static void latency_update_probe() {
+    if (probe < 0) return;
+    boolean busy = false;
+    for (int i = 0; i < latency_num_sources; i++) {
+        busy |= sources[i].stage != latency_stage_none;
+    }
+    digitalWrite(probe, busy ? HIGH : LOW);
+}
+
+#endif
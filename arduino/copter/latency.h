@@ -0,0 +1,87 @@
+// ArduinoCopter
+// latency.h
+//
+// Created October 19, 2026
+//
+// Measures the time from a button press or release to the moment the display
+// shows the copter redrawn after it. Samples are collected into a histogram
+// for each input source, with buckets that double in size, so that a session
+// of play can be summarized over serial.
+//
+// An input is timestamped with latency_input() when the game first sees it,
+// which is when the hardware button is polled or when a Bluetooth command is
+// parsed. The next tick that redraws the copter marks it with latency_tick(),
+// and latency_poll() completes the sample once everything drawn by that tick
+// has been sent to the display. Ticks that leave the copter where it is, such
+// as the frames dropped when the game sheds work (see governor.h), don't count,
+// so the sample ends at the first frame that could show the input. A probe pin
+// can be raised for the duration of a sample, so that the latency can also be
+// measured with a scope against the button signal.
+//
+// Only compiled in when LATENCY_STATS is defined (see the Makefile).
+
+#ifndef __latency_h__
+#define __latency_h__
+#include <Arduino.h>
+
+#ifdef LATENCY_STATS
+
+// Number of buckets in a latency histogram. Bucket n counts latencies of
+// [2^n, 2^(n+1)) microseconds, and the last bucket counts everything longer.
+#define LATENCY_NUM_BUCKETS 16
+
+// Sources of input that latencies are measured for.
+typedef enum {
+    latency_source_button,      // The hardware button.
+    latency_source_bluetooth,   // The Bluetooth controller.
+    latency_num_sources
+} latency_source;
+
+typedef struct {
+    uint16_t buckets[LATENCY_NUM_BUCKETS];  // Number of samples in each bucket.
+    uint16_t count;                         // Total number of samples.
+    uint32_t total;                         // Sum of the samples, in microseconds.
+    uint32_t max;                           // Longest sample, in microseconds.
+} latency_histogram;
+
+// Clears the histograms and sets up the probe pin.
+//
+// @param probe_pin Pin that is held high while a sample is in progress, or -1
+//                  for none.
+void latency_init(int probe_pin);
+
+// Records the arrival of an input. If an earlier input from the same source
+// hasn't reached the display yet, the sample keeps the earlier timestamp.
+//
+// @param source The source of the input.
+void latency_input(latency_source source);
+
+// Marks the inputs that have arrived so far as shown by the tick that just ran,
+// if it redrew the copter.
+//
+// @param copter_redrawn Whether the tick redrew the copter (see
+//                       scene::copter_redrawn).
+void latency_tick(boolean copter_redrawn);
+
+// Completes the samples whose tick has been drawn, once the display has caught
+// up with the drawing. Call this whenever there is time to spare.
+void latency_poll();
+
+// Drops the samples in progress, e.g. when a round ends before they are drawn.
+void latency_cancel();
+
+// Returns the histogram for an input source.
+//
+// @param source    The input source.
+// @param hist      Pointer to the struct to copy the histogram into.
+void latency_get(latency_source source, latency_histogram *hist);
+
+// Prints the histogram of every input source, listing the lower bound (in
+// microseconds) and count of each bucket that has samples in it.
+//
+// @param out The stream to print to (e.g. &Serial).
+void latency_print(Print *out);
+
+#endif
+
+#endif
@@ -0,0 +1,171 @@
+// ArduinoCopter
+// memory_stats.cpp
+//
+// Created October 19, 2026
+//
+
+#include "memory_stats.h"
+
+#ifdef MEMORY_STATS
+
+// =========== Types ============
+
+// A block on the malloc() free list, as laid out by avr-libc.
+struct __freelist {
+    size_t sz;                  // Usable size of the block, after this header's `sz`.
+    struct __freelist *nx;      // Next free block, or NULL.
+};
+
+// Symbols from the linker script and avr-libc's malloc().
+extern char __data_start;           // Start of .data, the first static variable.
+extern char __heap_start;           // End of .bss, where the heap begins.
+extern char *__brkval;              // Top of the heap, or NULL before the first malloc().
+extern size_t __malloc_margin;      // Space malloc() keeps free below the stack.
+extern struct __freelist *__flp;    // Head of the free list.
+
+// =========== Function Declarations ============
+
+// Paints the memory between the static variables and the top of the stack.
+// Placed in .init3 so that it runs before main(), once the stack pointer and
+// zero register have been set up but before anything has been pushed.
+void memory_paint() __attribute__((naked, used, section(".init3")));
+
+// Returns the top of the heap.
+static char *memory_heap_top();
+
+// =========== Constants ============
+
+// Byte that unused stack space is painted with.
+static const uint8_t paint_byte = 0xC5;
+
+// =========== Global Variables ============
+
+static memory_usage usage[memory_num_subsystems];
+
+// Highest the top of the heap has been. The stack watermark is scanned from
+// here, since the heap may have shrunk back from memory the stack never reached.
+static char *heap_peak = NULL;
+
+// Names of the subsystems, as printed by memory_print().
+static const char * const subsystem_names[memory_num_subsystems] = {"scene", "gen", "verify"};
+
+// =========== Public API ============
+// All Public APIs are documented in memory_stats.h
+
+void *memory_alloc(memory_subsystem subsystem, size_t size) {
+    void *ptr = arena_alloc(size);
+    memory_usage *u = &usage[subsystem];
+    if (ptr == NULL) {
+        u->failures++;
+        return NULL;
+    }
+    u->allocs++;
+    u->bytes += size;
+    u->peak_bytes = max(u->peak_bytes, u->bytes);
+    return ptr;
+}
+
+void memory_free(memory_subsystem subsystem, void *ptr, size_t size) {
+    if (ptr == NULL) return;
+    arena_free(ptr, size);
+    memory_usage *u = &usage[subsystem];
+    u->frees++;
+    u->bytes -= size;
+}
+
+void memory_get(memory_snapshot *snapshot) {
+    char *heap_top = memory_heap_top();
+    char *stack_top = (char *)SP;
+    heap_peak = max(heap_peak, heap_top);
+
+    snapshot->static_bytes = &__heap_start - &__data_start;
+    snapshot->heap_bytes = heap_top - &__heap_start;
+    snapshot->stack_bytes = RAMEND - SP;
+
+    // Walk the free list for the free space inside the heap.
+    uint16_t largest = 0;
+    snapshot->heap_free = 0;
+    for (struct __freelist *fp = __flp; fp != NULL; fp = fp->nx) {
+        snapshot->heap_free += fp->sz + sizeof(size_t);
+        largest = max(largest, fp->sz);
+    }
+
+    // Anything else has to come from between the heap and the stack, which
+    // malloc() only hands out up to a margin below the stack pointer.
+    uint16_t gap = stack_top - heap_top;
+    uint16_t reserved = __malloc_margin + sizeof(size_t);
+    if (gap > reserved) {
+        largest = max(largest, gap - reserved);
+    }
+    snapshot->free_bytes = snapshot->heap_free + gap;
+    snapshot->largest_free = largest;
+
+    // The first byte above the heap that isn't paint is the deepest the stack
+    // has reached.
+    uint8_t *p = (uint8_t *)heap_peak;
+    while (p < (uint8_t *)stack_top && *p == paint_byte) {
+        p++;
+    }
+    snapshot->min_gap = p - (uint8_t *)heap_peak;
+    snapshot->stack_peak = (uint8_t *)RAMEND - p;
+}
+
+void memory_get_usage(memory_subsystem subsystem, memory_usage *u) {
+    *u = usage[subsystem];
+}
+
+void memory_print(Print *out) {
+    memory_snapshot snapshot;
+    memory_get(&snapshot);
+    out->print("mem static:");
+    out->print(snapshot.static_bytes);
+    out->print(" heap:");
+    out->print(snapshot.heap_bytes);
+    out->print(" free:");
+    out->print(snapshot.free_bytes);
+    out->print(" largest:");
+    out->print(snapshot.largest_free);
+    out->print(" stack:");
+    out->print(snapshot.stack_bytes);
+    out->print(" peak:");
+    out->print(snapshot.stack_peak);
+    out->print(" min gap:");
+    out->println(snapshot.min_gap);
+
+    out->print("mem arena used:");
+    out->print(arena_used());
+    out->print(" peak:");
+    out->print(arena_peak());
+    out->print(" size:");
+    out->println(arena_size());
+
+    for (int i = 0; i < memory_num_subsystems; i++) {
+        const memory_usage *u = &usage[i];
+        out->print("mem ");
+        out->print(subsystem_names[i]);
+        out->print(" bytes:");
+        out->print(u->bytes);
+        out->print(" peak:");
+        out->print(u->peak_bytes);
+        out->print(" allocs:");
+        out->print(u->allocs);
+        out->print(" frees:");
+        out->print(u->frees);
+        out->print(" failed:");
+        out->println(u->failures);
+    }
+}
+
+// =========== Private API ============
+
+void memory_paint() {
+    for (uint8_t *p = (uint8_t *)&__heap_start; p <= (uint8_t *)RAMEND; p++) {
+        *p = paint_byte;
+    }
+}
+
+static char *memory_heap_top() {
+    return (__brkval != NULL) ? __brkval : &__heap_start;
+}
+
+#endif
@@ -0,0 +1,96 @@
+// ArduinoCopter
+// memory_stats.h
+//
+// Created October 19, 2026
+//
+// Keeps track of how much of the 8 KB of SRAM is in use, to see how close each
+// display configuration gets to running out of memory.
+//
+// Before main() runs, the free space between the end of the static variables
+// and the top of the stack is painted with a known byte. Scanning up from the
+// top of the heap for the first byte that was overwritten gives the deepest the
+// stack has reached. The heap is measured by walking the malloc() free list,
+// and allocations made through MEMORY_ALLOC() are counted for each subsystem.
+//
+// Only compiled in when MEMORY_STATS is defined (see the Makefile). Without it,
+// MEMORY_ALLOC() and MEMORY_FREE() are plain arena_alloc() and arena_free()
+// (see arena.h).
+
+#ifndef __memory_stats_h__
+#define __memory_stats_h__
+#include <Arduino.h>
+#include "arena.h"
+
+// Subsystems that allocations are counted for.
+typedef enum {
+    memory_subsystem_scene,         // The scene and its block array.
+    memory_subsystem_generator,     // The generator and its terrain segments.
+    memory_subsystem_verifier,      // The playability verifier and its states.
+    memory_num_subsystems
+} memory_subsystem;
+
+#ifdef MEMORY_STATS
+
+#define MEMORY_ALLOC(subsystem, size) memory_alloc(subsystem, size)
+#define MEMORY_FREE(subsystem, ptr, size) memory_free(subsystem, ptr, size)
+
+// Allocations made by a subsystem.
+typedef struct {
+    uint16_t bytes;         // Bytes currently allocated.
+    uint16_t peak_bytes;    // Most bytes allocated at once.
+    uint16_t allocs;        // Number of successful allocations.
+    uint16_t frees;         // Number of frees.
+    uint16_t failures;      // Number of allocations that returned NULL.
+} memory_usage;
+
+// A snapshot of the SRAM in use.
+typedef struct {
+    uint16_t static_bytes;  // .data and .bss, fixed at link time.
+    uint16_t heap_bytes;    // Size of the heap, including free blocks inside it.
+    uint16_t heap_free;     // Bytes in the free list inside the heap.
+    uint16_t free_bytes;    // Free list plus the space between heap and stack.
+    uint16_t largest_free;  // Largest block that malloc() could return right now.
+    uint16_t stack_bytes;   // Stack in use at the time of the snapshot.
+    uint16_t stack_peak;    // Deepest the stack has been since reset.
+    uint16_t min_gap;       // Fewest bytes ever left untouched between heap and stack.
+} memory_snapshot;
+
+// Allocates memory from the arena and counts it against a subsystem.
+//
+// @param subsystem The subsystem making the allocation.
+// @param size      Number of bytes to allocate.
+// @return The allocated memory, or NULL if there isn't enough.
+void *memory_alloc(memory_subsystem subsystem, size_t size);
+
+// Frees memory allocated with memory_alloc(), as arena_free() does.
+//
+// @param subsystem The subsystem that made the allocation.
+// @param ptr       The memory to free.
+// @param size      The size that was passed to memory_alloc().
+void memory_free(memory_subsystem subsystem, void *ptr, size_t size);
+
+// Measures the SRAM in use, including a scan for the stack watermark.
+//
+// @param snapshot Pointer to the struct to fill in.
+void memory_get(memory_snapshot *snapshot);
+
+// Returns the allocations made by a subsystem.
+//
+// @param subsystem The subsystem.
+// @param usage     Pointer to the struct to copy the counts into.
+void memory_get_usage(memory_subsystem subsystem, memory_usage *usage);
+
+// Prints a snapshot of the SRAM in use, followed by a line for the arena and a
+// line for each subsystem.
+//
+// @param out The stream to print to (e.g. &Serial).
+void memory_print(Print *out);
+
+#else
+
+#define MEMORY_ALLOC(subsystem, size) arena_alloc(size)
+#define MEMORY_FREE(subsystem, ptr, size) arena_free(ptr, size)
+
+#endif
+
+#endif
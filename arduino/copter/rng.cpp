@@ -0,0 +1,47 @@
+// ArduinoCopter
+// rng.cpp
+//
+// Created October 19, 2026
+//
+
+#include "rng.h"
+
+// =========== Constants ============
+
+// State used in place of a zero seed, which xorshift can't leave.
+static const uint32_t default_state = 2463534242UL;
+
+// =========== Public API ============
+// All Public APIs are documented in rng.h
+
+void rng_seed(rng *r, uint32_t seed) {
+    r->state = (seed != 0) ? seed : default_state;
+}
+
+uint32_t rng_next(rng *r) {
+    uint32_t x = r->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    r->state = x;
+    return x;
+}
+
+int rng_range(rng *r, int min, int max) {
+    if (max <= min) return min;
+    uint16_t span = (uint16_t)(max - min);
+
+    // Smallest all-ones mask that covers the span. Masked values land in range
+    // at least half of the time, so only a couple of draws are needed on average.
+    uint16_t mask = span - 1;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+    mask |= mask >> 8;
+
+    uint16_t v;
+    do {
+        v = (uint16_t)(rng_next(r) >> 16) & mask;
+    } while (v >= span);
+    return min + (int)v;
+}
@@ -0,0 +1,39 @@
+// ArduinoCopter
+// rng.h
+//
+// Created October 19, 2026
+//
+// A small, fast pseudo random number generator (32-bit xorshift) used in place
+// of the Arduino's random(). The whole state is a single 32-bit word, so it can
+// be saved and restored to replay exactly the same sequence of numbers.
+
+#ifndef __rng_h__
+#define __rng_h__
+#include <Arduino.h>
+
+typedef struct {
+    uint32_t state;     // Current state of the generator. Never 0.
+} rng;
+
+// Seeds a generator.
+//
+// @param r     Pointer to the generator to seed.
+// @param seed  The seed. Any value is allowed, including 0.
+void rng_seed(rng *r, uint32_t seed);
+
+// Returns the next 32 random bits from a generator.
+//
+// @param r Pointer to the generator.
+uint32_t rng_next(rng *r);
+
+// Returns a uniformly distributed random number in a range. Unlike random() this
+// doesn't divide; out of range values are rejected and redrawn instead.
+//
+// @param r     Pointer to the generator.
+// @param min   Lower bound of the range (inclusive).
+// @param max   Upper bound of the range (exclusive).
+//
+// @return A number between min and max - 1, or min if max <= min.
+int rng_range(rng *r, int min, int max);
+
+#endif
@@ -7,54 +7,132 @@
 #include "scene.h"
 #include "helicopter.h"
 #include "drawing_utils.h"
+#include "memory_stats.h"
+#include "bench_stages.h"
 
 // =========== Function Declarations ============
 
-// Clears the screen and draws the initial scene.
+// Draws the initial scene over the whole screen, except for the overlay
+// region, which is left to its owner to redraw.
 //
 // @param s Pointer to the `scene` to draw.
 //
 static void scene_initial_draw(scene *s);
 
-// Does a partial redraw of the scene for a new set of frames. Only
-// updates the pixels that are necessary, versus doing a complete redraw.
+// Resets the blocks and copter to their state at the start of a round.
 //
-// @param s             Pointer to the `scene` to redraw.
-// @param new_frames    The new array of frames to draw.
+// @param s Pointer to the `scene` to reset.
 //
-static void scene_redraw_frames(scene *s, gen_frame *new_frames);
+static void scene_reset_state(scene *s);
 
-// Generate an array of updated frames for a screen update.
+// Does a partial redraw of the terrain as it moves to the left, before the
+// frames are popped from the generator. Only updates the pixels that are necessary,
+// versus doing a complete redraw. Columns inside a flat segment don't change,
+// so they are skipped without being looked at.
 //
-// @param s Pointer to the `scene` to generate new frames for.
-// @return The updated array of frames.
-static gen_frame * scene_update_frames(scene *s);
+// @param s     Pointer to the `scene` to redraw.
+// @param step  Number of frames that the terrain moves to the left.
+//
+static void scene_redraw_frames(scene *s, int step);
+
+// Updates the pixels of a column of terrain that differ between two frames.
+//
+// @param s         Pointer to the `scene` to redraw.
+// @param x         The x coordinate of the column.
+// @param old_frame The frame currently drawn in the column.
+// @param new_frame The frame to draw.
+static void scene_redraw_column(scene *s, int x, gen_frame old_frame, gen_frame new_frame);
+
+// Draws columns of terrain with the same frame, including the background
+// between the top and bottom boundaries.
+//
+// @param s     Pointer to the `scene` to draw into.
+// @param x     The x coordinate of the first column.
+// @param width Number of columns to draw.
+// @param frame The frame to draw.
+static void scene_draw_frames(scene *s, int x, int width, gen_frame frame);
+
+// Draws a rect of terrain or blocks underneath the copter, leaving out the
+// pixels of the copter and the part of the rect that intersects the scene's
+// overlay region.
+//
+// @param s     Pointer to the `scene` to draw into.
+// @param r     The rect to draw.
+// @param color The color to fill the rect with.
+static void scene_draw_rect(scene *s, g_rect r, int color);
+
+// Fills a rect, leaving out the part of it that intersects the scene's
+// overlay region.
+//
+// @param s     Pointer to the `scene` to draw into.
+// @param r     The rect to fill.
+// @param color The color to fill the rect with.
+static void scene_fill_rect(scene *s, g_rect r, int color);
+
+// Draws the columns of a block between two x coordinates, clipped to the
+// display and the scene's overlay region.
+//
+// @param s     Pointer to the `scene` to draw into.
+// @param min_x The first column to draw.
+// @param max_x The column after the last column to draw.
+// @param r     The block rect, from which the vertical extent is taken.
+// @param color The color to fill the columns with.
+static void scene_draw_block_columns(scene *s, int min_x, int max_x, g_rect r, int color);
+
+// Pops frames from the generator for a screen update. Blocks that the
+// generator places in the new frames are inserted as the frames are popped.
+//
+// @param s     Pointer to the `scene` to pop frames for.
+// @param step  Number of frames to pop from the generator.
+static void scene_update_frames(scene *s, int step);
 
 // Update underlying data for block layout. Handles updating the origins
-// of on-screen blocks, removing off-screen blocks, and inserting blocks
-// at the appropriate distaince intervals.
+// of on-screen blocks and removing off-screen blocks.
 //
-// @param s Pointer to the `scene` for which to update the blocks.
-static void scene_update_blocks(scene *s);
+// @param s     Pointer to the `scene` for which to update the blocks.
+// @param step  Number of columns that the blocks move to the left.
+static void scene_update_blocks(scene *s, int step);
 
-// Inserts a new block at the end of the block rects array. The block is 
-// positioned to start at the right edge of the display.
+// Inserts a new block at the end of the block rects array.
 //
 // @param s Pointer to the `scene` for which to insert a block.
-static void scene_insert_block(scene *s);
+// @param x The origin x of the block, before the blocks are moved for this update.
+// @param y The origin y of the block, as placed by the generator.
+static void scene_insert_block(scene *s, int x, int y);
 
 // Updates the position of the blocks on screen.
 //
-// @param s Pointer to the `scene` for which to redraw the blocks.
-static void scene_redraw_blocks(scene *s);
+// @param s     Pointer to the `scene` for which to redraw the blocks.
+// @param step  Number of columns that the blocks move to the left.
+static void scene_redraw_blocks(scene *s, int step);
 
-// Detects whether there was a collision with an obstacle or boundary.
+// Detects whether the pixels of the copter overlap an obstacle or boundary.
+// Each column of the copter's mask is ANDed against a mask of the terrain
+// and block pixels in the same column.
 //
 // @param s Pointer to the `scene` for which to check collisions.
-// @param r The rect of the object that is potentially colliding with an obstacle.
+// @param p The origin of the copter.
 //
-// @return Whether the object is colliding with an obstacle or boundary.
-static boolean scene_detect_collision(scene *s, g_rect r);
+// @return Whether the copter is colliding with an obstacle or boundary.
+static boolean scene_detect_collision(scene *s, g_point p);
+
+// Redraws the copter where it is now, after it has moved or changed animation
+// frame since it was drawn. Only the pixels that change are drawn: pixels that
+// the copter uncovers are rebuilt in the color of the terrain, block or
+// background beneath them, and pixels that it newly covers are filled with the
+// copter color. Each column is drawn as vertical spans of the same color.
+//
+// @param s Pointer to the `scene` to draw into.
+static void scene_composite_copter(scene *s);
+
+// Returns the color that a pixel has without the copter on top of it.
+//
+// @param s             Pointer to the `scene`.
+// @param frame         The terrain frame of the pixel's column.
+// @param blocks        The blocks that may cover the pixel.
+// @param num_blocks    The number of blocks in `blocks`.
+// @param p             The pixel.
+static int scene_layer_color(scene *s, gen_frame frame, const g_rect *blocks, int num_blocks, g_point p);
 
 // Updates the coordinates of the copter based on the given direction.
 //
@@ -64,17 +142,12 @@ static void scene_update_copter(scene *s, copter_direction dir);
 
 // =========== Constants ============
 
-typedef struct {
-    int max;
-    float damping;
-} physics_unit;
-
-// Spacing between the edges of the terrain and the obstacle blocks.
-static const int block_edge_margin = 10;
+// Number of upcoming frames generated by each call to scene_idle().
+static const int idle_gen_batch = 2;
 
-// Physics units (defined by max and damping) for gravity and boost.
-static const physics_unit gravity = {5, 0.6};
-static const physics_unit boost = {10, 0.5};
+// Number of updates that the playability states are moved through by each
+// call to scene_idle().
+static const int idle_verify_batch = 1;
 
 // =========== Macros ============
 
@@ -93,144 +166,349 @@ scene * scene_new(Adafruit_GFX *tft,
                   int max_d, 
                   int blk_d, 
                   g_size blk_size,
-                  scene_colors colors) {
-    // Calculate maximum number of obstacle blocks that could be present on screen
-    // at a given time in order to figure out how large to make the block_rects array.
-    int max_blk = ceilf((float)tft_size.width / (float)(blk_size.width + blk_d)) * 2;
+                  scene_colors colors,
+                  rng *random) {
+    int max_blk = SCENE_MAX_BLOCKS(tft_size.width, blk_d, blk_size.width);
 
-    scene *s = (scene *)malloc(sizeof(scene));
+    scene *s = (scene *)MEMORY_ALLOC(memory_subsystem_scene, sizeof(scene));
     s->tft = tft;
     s->colors = colors;
-    s->block_rects = (g_rect *)malloc(max_blk * sizeof(g_rect));
-    s->num_blocks = 0;
-    s->last_block_d = 0;
+    s->block_rects = (g_rect *)MEMORY_ALLOC(memory_subsystem_scene, max_blk * sizeof(g_rect));
+    s->max_blocks = max_blk;
     s->block_size = blk_size;
-    s->max_block_d = blk_d;
-    s->copter_pos = (g_point){10, (tft_size.height / 2) - (helicopter_size.height / 2)};
-    s->copter_gravity = 0;
-    s->copter_boost = 0;
-    s->collided = false;
-    s->gen = gen_new(tft_size, spacing, max_d);
+    s->overlay = (g_rect){{0, 0}, {0, 0}};
+    s->scroll_step = 1;
+    s->detail = scene_detail_full;
+    s->gen = gen_new(tft_size, spacing, max_d, blk_d, blk_size, random);
+    s->playability = verifier_new(s->gen, SCENE_MAX_STEP);
+    s->num_frames = s->gen->num_frames;
     scene_initial_draw(s);
+    scene_reset_state(s);
     return s;
 }
 
-boolean scene_update(scene *s, copter_direction dir) {
-    // Redraw the scene with the updated frames.
-    gen_frame *frames = scene_update_frames(s);
-    scene_redraw_frames(s, frames);
+void scene_reset(scene *s) {
+    gen_reset(s->gen);
+    scene_initial_draw(s);
+    scene_reset_state(s);
+}
+
+void scene_redraw(scene *s) {
+    scene_initial_draw(s);
+    for (size_t i = 0; i < s->num_blocks; i++) {
+        g_rect r = s->block_rects[i];
+        scene_draw_block_columns(s, r.origin.x, g_rect_maxx(r), r, COL_BLCK(s));
+    }
+    scene_composite_copter(s);
+}
 
-    // Update the frame array of the scene struct.
-    free(s->frames);
-    s->frames = frames;
+void scene_idle(scene *s) {
+    // Generating a frame is quick, so it is done in small batches.
+    int count = 0;
+    while (count < idle_gen_batch) {
+        if (gen_fill_lookahead(s->gen, 1) == 0) break;
+        count++;
+    }
 
-    scene_redraw_blocks(s);
-    scene_update_blocks(s);
+    // Then move the playability states along with the new frames, so that
+    // checking the next block only has to look at the block itself.
+    count = 0;
+    while (count < idle_verify_batch) {
+        if (!verifier_advance(s->playability)) break;
+        count++;
+    }
+}
 
+void scene_set_overlay(scene *s, g_rect r) {
+    s->overlay = r;
+}
+
+void scene_set_speed(scene *s, int step) {
+    s->scroll_step = constrain(step, 1, SCENE_MAX_STEP);
+    verifier_set_step(s->playability, s->scroll_step, s->deferred_scroll);
+}
+
+void scene_set_detail(scene *s, scene_detail detail) {
+    s->detail = detail;
+}
+
+boolean scene_update(scene *s, copter_direction dir) {
+    // Redraw the terrain with the frames that are about to scroll in, then pop
+    // them. When scrolling by several columns this is still a single pass over
+    // the segments of the terrain. At lower detail, every other update leaves
+    // the terrain and blocks where they are and the next one scrolls them for
+    // both, as long as that stays within the largest step.
+    int step = s->scroll_step;
+    int scroll = s->deferred_scroll + step;
+    boolean draw = s->detail < scene_detail_coalesce_terrain || s->deferred_scroll > 0 ||
+                   scroll + step > SCENE_MAX_STEP;
+    if (draw) {
+        BENCH_STAGE(bench_stage_redraw_frames);
+        scene_redraw_frames(s, scroll);
+        BENCH_STAGE(bench_stage_update_frames);
+        scene_update_frames(s, scroll);
+
+        BENCH_STAGE(bench_stage_redraw_blocks);
+        scene_redraw_blocks(s, scroll);
+        BENCH_STAGE(bench_stage_update_blocks);
+        scene_update_blocks(s, scroll);
+        s->deferred_scroll = 0;
+    } else {
+        s->deferred_scroll = scroll;
+    }
+
+    BENCH_STAGE(bench_stage_update_copter);
     g_point old_pos = s->copter_pos;
     scene_update_copter(s, dir);
     g_point new_pos = s->copter_pos;
 
-    if (new_pos.y != old_pos.y) {
-        g_rect copter_rect = (g_rect){old_pos, helicopter_size};
-        draw_rect(s->tft, copter_rect, COL_BG(s));
-        helicopter_draw(s->tft, s->copter_pos, COL_CPTR(s));
-        copter_rect = (g_rect){new_pos, helicopter_size};
-        s->collided = scene_detect_collision(s, copter_rect);
+    // The blade alternates between halves every time the copter moves.
+    if (s->detail == scene_detail_full && (new_pos.y != old_pos.y || s->copter_visible == false)) {
+        s->copter_frame = (s->copter_frame + 1) % HELICOPTER_NUM_FRAMES;
+    }
+
+    BENCH_STAGE(bench_stage_draw_copter);
+    s->copter_redrawn = false;
+    if ((draw || s->detail < scene_detail_drop_frames) &&
+        (s->copter_visible == false || new_pos.y != s->copter_drawn_pos.y ||
+         s->copter_frame != s->copter_drawn_frame)) {
+        scene_composite_copter(s);
+    }
+
+    // Blocks keep moving even when the copter doesn't, so this is checked on
+    // every update. Moving the world `lag` columns back to where it was partway
+    // through the update is the same as moving the copter `lag` columns left,
+    // so the skipped columns are swept by checking those positions as well.
+    // Columns that haven't been scrolled on screen yet move the copter right
+    // by as much.
+    BENCH_STAGE(bench_stage_collision);
+    s->collided = false;
+    for (int lag = step - 1; lag >= 0 && s->collided == false; lag--) {
+        g_point p = (g_point){new_pos.x + s->deferred_scroll - lag, new_pos.y};
+        s->collided = scene_detect_collision(s, p);
     }
+    BENCH_STAGE(bench_stage_none);
     return s->collided;
 }
 
 void scene_free(scene *s) {
-    free(s->frames);
-    free(s->block_rects);
+    // In the reverse order of scene_new(), so that all of it goes back to the arena.
+    verifier_free(s->playability);
     gen_free(s->gen);
-    free(s);
+    MEMORY_FREE(memory_subsystem_scene, s->block_rects, s->max_blocks * sizeof(g_rect));
+    MEMORY_FREE(memory_subsystem_scene, s, sizeof(scene));
 }
 
 // =========== Private API ============
 
-static void scene_redraw_frames(scene *s, gen_frame *new_frames) {
-    gen_frame *old_frames = s->frames;
-    for (int i = 0; i < s->num_frames; i++) {
-        gen_frame old_frame = old_frames[i];
-        gen_frame new_frame = new_frames[i];
-
-        int old_height = old_frame.top_height;
-        int new_height = new_frame.top_height;
-        int delta = new_height - old_height;
-
-        Adafruit_GFX *tft = s->tft;
+static void scene_redraw_frames(scene *s, int step) {
+    generator *gen = s->gen;
+    size_t count = gen_num_segments(gen);
+    int x = 0;
+    for (size_t n = 0; n < count; n++) {
+        gen_segment seg = gen_segment_at(gen, n);
+        int end = x + seg.length;
+
+        // Columns that the same segment scrolls into change by the same amount,
+        // which is nothing at all for a flat segment.
+        int inner_end = end - step;
+        if (seg.slope != 0) {
+            for (int i = 0; i < inner_end - x; i++) {
+                gen_frame old_frame = gen_segment_frame(gen, seg, i);
+                gen_frame new_frame = gen_segment_frame(gen, seg, i + step);
+                scene_redraw_column(s, x + i, old_frame, new_frame);
+            }
+        }
 
-        // Fill or erase pixels from the top boundary depending on the
-        // change in height (delta).
-        if (delta > 0) {
-            draw_rect(s->tft, (g_rect){{i, old_height}, {1, delta}}, COL_TER(s));
-        } else if (delta < 0) {
-            draw_rect(s->tft, (g_rect){{i, old_height + delta}, {1, -delta}}, COL_BG(s));
+        // The last columns of the segment are replaced by frames from the
+        // segments after it, or from the look-ahead buffer past the last one.
+        size_t next = n + 1;
+        int next_x = end;
+        for (int i = max(x, inner_end); i < end; i++) {
+            int new_x = i + step;
+            gen_frame new_frame;
+            while (next < count) {
+                gen_segment next_seg = gen_segment_at(gen, next);
+                if (new_x < next_x + next_seg.length) {
+                    new_frame = gen_segment_frame(gen, next_seg, new_x - next_x);
+                    break;
+                }
+                next_x += next_seg.length;
+                next++;
+            }
+            if (next == count) {
+                new_frame = gen_frame_at(gen, new_x);
+            }
+            scene_redraw_column(s, i, gen_segment_frame(gen, seg, i - x), new_frame);
         }
+        x = end;
+    }
+}
 
-        // Same for the bottom boundary.
-        old_height = old_frame.bottom_height;
-        new_height = new_frame.bottom_height;
-        delta = new_height - old_height;
+static void scene_redraw_column(scene *s, int x, gen_frame old_frame, gen_frame new_frame) {
+    int old_height = old_frame.top_height;
+    int new_height = new_frame.top_height;
+    int delta = new_height - old_height;
+
+    // Fill or erase pixels from the top boundary depending on the
+    // change in height (delta).
+    if (delta > 0) {
+        scene_draw_rect(s, (g_rect){{x, old_height}, {1, delta}}, COL_TER(s));
+    } else if (delta < 0) {
+        scene_draw_rect(s, (g_rect){{x, old_height + delta}, {1, -delta}}, COL_BG(s));
+    }
 
-        int gen_height = s->gen->size.height;
-        if (delta > 0) {
-            draw_rect(s->tft, (g_rect){{i, gen_height - old_height}, {1, delta}}, COL_TER(s));
-        } else if (delta < 0) {
-            draw_rect(s->tft, (g_rect){{i, gen_height - old_height}, {1, -delta}}, COL_BG(s));
-        }
+    // Same for the bottom boundary.
+    old_height = old_frame.bottom_height;
+    new_height = new_frame.bottom_height;
+    delta = new_height - old_height;
+
+    int gen_height = s->gen->size.height;
+    if (delta > 0) {
+        scene_draw_rect(s, (g_rect){{x, gen_height - new_height}, {1, delta}}, COL_TER(s));
+    } else if (delta < 0) {
+        scene_draw_rect(s, (g_rect){{x, gen_height - old_height}, {1, -delta}}, COL_BG(s));
     }
 }
 
+static void scene_reset_state(scene *s) {
+    g_size size = s->gen->size;
+    s->num_blocks = 0;
+    s->copter_pos = (g_point){10, (size.height / 2) - (helicopter_size.height / 2)};
+    s->copter_frame = 0;
+    s->copter_visible = false;
+    s->copter_redrawn = false;
+    s->deferred_scroll = 0;
+    s->copter_gravity = 0;
+    s->copter_boost = 0;
+    s->collided = false;
+    verifier_reset(s->playability, s->copter_pos.x);
+}
+
 static void scene_initial_draw(scene *s) {
-    Adafruit_GFX *tft = s->tft;
-    tft->fillScreen(COL_BG(s));
+    // Everything is drawn over, including the copter.
+    s->copter_visible = false;
 
+    // A flat segment is drawn as one run of columns, and the gap between the
+    // boundaries is cleared as part of the same run rather than clearing the
+    // whole screen first, so every pixel is written once.
     generator *gen = s->gen;
-    size_t len = gen->num_frames;
-    size_t bytes = len * sizeof(gen_frame);
-    gen_frame *frames = (gen_frame *)malloc(bytes);
-    memcpy(frames, gen->frames, bytes);
+    size_t count = gen_num_segments(gen);
+    int x = 0;
+    for (size_t n = 0; n < count; n++) {
+        gen_segment seg = gen_segment_at(gen, n);
+        if (seg.slope == 0) {
+            scene_draw_frames(s, x, seg.length, gen_segment_frame(gen, seg, 0));
+        } else {
+            for (int i = 0; i < seg.length; i++) {
+                scene_draw_frames(s, x + i, 1, gen_segment_frame(gen, seg, i));
+            }
+        }
+        x += seg.length;
+    }
+}
 
-    for (int i = 0; i < len; i++) {
-        gen_frame frame = frames[i];
-        draw_rect(s->tft, (g_rect){{i, 0}, {1, frame.top_height}}, COL_TER(s));
-        draw_rect(s->tft, (g_rect){{i, gen->size.height - frame.bottom_height}, {1, frame.bottom_height}}, COL_TER(s));
+static void scene_draw_frames(scene *s, int x, int width, gen_frame frame) {
+    int gap_y = frame.top_height;
+    int bottom_y = s->gen->size.height - frame.bottom_height;
+    scene_draw_rect(s, (g_rect){{x, 0}, {width, gap_y}}, COL_TER(s));
+    scene_draw_rect(s, (g_rect){{x, gap_y}, {width, bottom_y - gap_y}}, COL_BG(s));
+    scene_draw_rect(s, (g_rect){{x, bottom_y}, {width, frame.bottom_height}}, COL_TER(s));
+}
+
+static void scene_draw_rect(scene *s, g_rect r, int color) {
+    if (r.size.width <= 0 || r.size.height <= 0) return;
+    g_rect c = (g_rect){s->copter_drawn_pos, helicopter_size};
+    if (s->copter_visible == false || !g_rect_intersects(r, c)) {
+        scene_fill_rect(s, r, color);
+        return;
+    }
+
+    // Fill the columns to either side of the copter as they are.
+    int min_x = r.origin.x, max_x = g_rect_maxx(r);
+    int c_min_x = max(min_x, c.origin.x);
+    int c_max_x = min(max_x, g_rect_maxx(c));
+    int min_y = r.origin.y, max_y = g_rect_maxy(r);
+    if (c_min_x > min_x) {
+        scene_fill_rect(s, (g_rect){{min_x, min_y}, {c_min_x - min_x, r.size.height}}, color);
+    }
+    if (max_x > c_max_x) {
+        scene_fill_rect(s, (g_rect){{c_max_x, min_y}, {max_x - c_max_x, r.size.height}}, color);
     }
 
-    s->frames = frames;
-    s->num_frames = len;
+    // In the columns shared with the copter, only its rows can be covered, so
+    // fill the runs between the pixels of the copter.
+    int band_min_y = max(min_y, c.origin.y);
+    int band_max_y = min(max_y, g_rect_maxy(c));
+    for (int x = c_min_x; x < c_max_x; x++) {
+        uint8_t mask = helicopter_frame_mask(s->copter_drawn_frame, x - c.origin.x);
+        int run_start = min_y;
+        for (int y = band_min_y; y < band_max_y; y++) {
+            if ((mask >> (y - c.origin.y)) & 1) {
+                if (y > run_start) {
+                    scene_fill_rect(s, (g_rect){{x, run_start}, {1, y - run_start}}, color);
+                }
+                run_start = y + 1;
+            }
+        }
+        if (max_y > run_start) {
+            scene_fill_rect(s, (g_rect){{x, run_start}, {1, max_y - run_start}}, color);
+        }
+    }
 }
 
-static gen_frame * scene_update_frames(scene *s) {
-    // Pop the leftmost frame from the generator.
-    gen_frame new_frame;
-    gen_frame popped_frame = gen_pop_frame(s->gen, &new_frame);
+static void scene_fill_rect(scene *s, g_rect r, int color) {
+    g_rect o = s->overlay;
+    if (r.size.width <= 0 || r.size.height <= 0) return;
+    if (!g_rect_intersects(r, o)) {
+        draw_rect(s->tft, r, color);
+        return;
+    }
 
-    // Create a copy of the original frames array to update.
-    gen_frame *old_frames = s->frames;
-    size_t len = s->num_frames;
-    gen_frame *frames = (gen_frame *)malloc(len * sizeof(gen_frame));
+    // Split the rect into the (up to 4) pieces surrounding the overlay.
+    int min_x = r.origin.x, max_x = g_rect_maxx(r);
+    int min_y = r.origin.y, max_y = g_rect_maxy(r);
+    int o_min_y = max(min_y, o.origin.y);
+    int o_max_y = min(max_y, g_rect_maxy(o));
+    if (o_min_y > min_y) {
+        draw_rect(s->tft, (g_rect){{min_x, min_y}, {max_x - min_x, o_min_y - min_y}}, color);
+    }
+    if (max_y > o_max_y) {
+        draw_rect(s->tft, (g_rect){{min_x, o_max_y}, {max_x - min_x, max_y - o_max_y}}, color);
+    }
+    if (o.origin.x > min_x) {
+        draw_rect(s->tft, (g_rect){{min_x, o_min_y}, {o.origin.x - min_x, o_max_y - o_min_y}}, color);
+    }
+    if (max_x > g_rect_maxx(o)) {
+        draw_rect(s->tft, (g_rect){{g_rect_maxx(o), o_min_y}, {max_x - g_rect_maxx(o), o_max_y - o_min_y}}, color);
+    }
+}
 
-    // Shift all the other frames to the left and replace the last element
-    // in the array with the newly created frame.
-    for (int i = 1; i < len; i++) {
-        frames[i - 1] = old_frames[i];
+static void scene_update_frames(scene *s, int step) {
+    // Pop the leftmost frames from the generator, which appends the new frames.
+    size_t len = s->num_frames;
+    for (int i = 1; i <= step; i++) {
+        gen_pop_frame(s->gen);
+        verifier_pop_frame(s->playability);
+
+        // The generator decides where blocks go. If one starts at the next frame,
+        // insert it where it will be just past the right edge once that frame
+        // has been popped.
+        int block_y = gen_next_block(s->gen);
+        if (block_y >= 0) {
+            scene_insert_block(s, len + i, block_y);
+        }
     }
-    frames[len - 1] = new_frame;
-    return frames;
 }
 
-static void scene_update_blocks(scene *s) {
+static void scene_update_blocks(scene *s, int step) {
     size_t len = s->num_blocks;
     g_rect *rects = s->block_rects;
     if (len) {
         int i = 0;
         while (i < len) {
             g_rect r = rects[i];
-            r.origin.x--;
+            r.origin.x -= step;
 
             // Remove the block once it has gone off screen and shift
             // the other blocks to the left one position in the array.
@@ -249,75 +527,168 @@ static void scene_update_blocks(scene *s) {
             }
         }
     }
-    // If the required sistance has passed, it's time to insert another block.
-    if (s->last_block_d >= s->max_block_d) {
-        scene_insert_block(s);
-        s->last_block_d = 0;
-    } else {
-        s->last_block_d++; 
-    }
 }
 
-static void scene_insert_block(scene *s) {
-    // Calculate the minimum and maximum constraints for the origin by taking
-    // into account the heights of the last frame, frame delta, block size, etc.
-    generator *g = s->gen;
-    size_t len = g->num_frames;
-    gen_frame f = g->frames[len - 1];
-    int max_delta = g->max_delta;
-    int min_origin = f.top_height + max_delta + block_edge_margin;
-    int max_origin = g->size.height - f.bottom_height - max_delta - block_edge_margin - s->block_size.height;
-    int origin = random(min_origin, max_origin);
-
-    g_rect rect = (g_rect){{len, origin}, s->block_size};
+static void scene_insert_block(scene *s, int x, int y) {
+    g_rect rect = (g_rect){{x, y}, s->block_size};
     s->num_blocks++;
     s->block_rects[s->num_blocks - 1] = rect;
 }
 
-static void scene_redraw_blocks(scene *s) {
+static void scene_redraw_blocks(scene *s, int step) {
     size_t len = s->num_blocks;
     for (int i = 0; i < len; i++) {
+        // Erase the columns that the block leaves behind on the right and fill
+        // the columns that it moves into on the left.
         g_rect r = s->block_rects[i];
-        g_size slice_size = (g_size){1, r.size.height};
-        g_rect erase_rect = (g_rect){{r.origin.x + r.size.width - 1, r.origin.y}, slice_size};
-        g_rect fill_rect = (g_rect){{r.origin.x - 1, r.origin.y}, slice_size};
+        int old_x = r.origin.x;
+        int new_x = old_x - step;
+        int width = r.size.width;
+        scene_draw_block_columns(s, max(old_x, new_x + width), old_x + width, r, COL_BG(s));
+        scene_draw_block_columns(s, new_x, min(old_x, new_x + width), r, COL_BLCK(s));
+    }
+}
+
+static void scene_draw_block_columns(scene *s, int min_x, int max_x, g_rect r, int color) {
+    min_x = max(min_x, 0);
+    max_x = min(max_x, (int)s->num_frames);
+    if (max_x > min_x) {
+        scene_draw_rect(s, (g_rect){{min_x, r.origin.y}, {max_x - min_x, r.size.height}}, color);
+    }
+}
+
+static boolean scene_detect_collision(scene *s, g_point p) {
+    g_rect copter_rect = (g_rect){p, helicopter_size};
+
+    // Find the (at most one or two) blocks that are near the copter.
+    g_rect near_blocks[2];
+    int num_near = 0;
+    for (int i = 0; i < s->num_blocks && num_near < 2; i++) {
+        if (g_rect_intersects(copter_rect, s->block_rects[i])) {
+            near_blocks[num_near++] = s->block_rects[i];
+        }
+    }
+
+    for (int c = 0; c < helicopter_size.width; c++) {
+        uint8_t copter_mask = helicopter_mask(c);
+        if (copter_mask == 0) continue;
 
-        if (erase_rect.origin.x <= s->gen->size.width) {
-            draw_rect(s->tft, erase_rect, COL_BG(s));
+        int x = p.x + c;
+        uint8_t world_mask = gen_column_mask(s->gen, x, p.y);
+        for (int i = 0; i < num_near; i++) {
+            g_rect r = near_blocks[i];
+            if (x < r.origin.x || x >= g_rect_maxx(r)) continue;
+
+            // Rows of the block relative to the copter, clamped to the mask.
+            int top = max(r.origin.y - p.y, 0);
+            int bottom = min(g_rect_maxy(r) - p.y, 8);
+            world_mask |= ((1 << bottom) - 1) & ~((1 << top) - 1);
+        }
+        if (world_mask & copter_mask) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void scene_composite_copter(scene *s) {
+    // A copter that isn't drawn has nothing to uncover.
+    boolean was_visible = s->copter_visible;
+    g_point old_pos = was_visible ? s->copter_drawn_pos : s->copter_pos;
+    int old_frame = s->copter_drawn_frame;
+    g_point new_pos = s->copter_pos;
+    int new_frame = s->copter_frame;
+    s->copter_drawn_pos = new_pos;
+    s->copter_drawn_frame = new_frame;
+    s->copter_visible = true;
+    s->copter_redrawn = true;
+
+    g_rect old_rect = (g_rect){old_pos, helicopter_size};
+    g_rect new_rect = (g_rect){new_pos, helicopter_size};
+
+    // Area covered by the copter before or after the move, clipped to the screen.
+    int min_x = max(min(old_rect.origin.x, new_rect.origin.x), 0);
+    int max_x = min(max(g_rect_maxx(old_rect), g_rect_maxx(new_rect)), (int)s->num_frames);
+    int min_y = max(min(old_rect.origin.y, new_rect.origin.y), 0);
+    int max_y = min(max(g_rect_maxy(old_rect), g_rect_maxy(new_rect)), (int)s->gen->size.height);
+    if (max_x <= min_x || max_y <= min_y) return;
+    g_rect area = (g_rect){{min_x, min_y}, {max_x - min_x, max_y - min_y}};
+
+    // Find the (at most one or two) blocks that the uncovered pixels may be part of.
+    g_rect near_blocks[2];
+    int num_near = 0;
+    for (int i = 0; i < s->num_blocks && num_near < 2; i++) {
+        if (g_rect_intersects(area, s->block_rects[i])) {
+            near_blocks[num_near++] = s->block_rects[i];
         }
-        if (fill_rect.origin.x >= 0) {
-            draw_rect(s->tft, fill_rect, COL_BLCK(s));
+    }
+
+    for (int x = min_x; x < max_x; x++) {
+        uint8_t old_mask = 0;
+        if (was_visible) {
+            old_mask = helicopter_frame_mask(old_frame, x - old_pos.x);
+        }
+        uint8_t new_mask = helicopter_frame_mask(new_frame, x - new_pos.x);
+        gen_frame frame = gen_frame_at(s->gen, x);
+
+        // Walk down the column, drawing each run of changed pixels that share a
+        // color. The row past the end closes the last run.
+        boolean in_run = false;
+        int run_start = 0;
+        int run_color = 0;
+        for (int y = min_y; y <= max_y; y++) {
+            boolean changed = false;
+            int color = 0;
+            if (y < max_y) {
+                int old_row = y - old_pos.y;
+                int new_row = y - new_pos.y;
+                boolean was = old_row >= 0 && old_row < 8 && ((old_mask >> old_row) & 1);
+                boolean is = new_row >= 0 && new_row < 8 && ((new_mask >> new_row) & 1);
+                if (is && !was) {
+                    changed = true;
+                    color = COL_CPTR(s);
+                } else if (was && !is) {
+                    changed = true;
+                    color = scene_layer_color(s, frame, near_blocks, num_near, (g_point){x, y});
+                }
+            }
+            if (in_run && (!changed || color != run_color)) {
+                scene_fill_rect(s, (g_rect){{x, run_start}, {1, y - run_start}}, run_color);
+                in_run = false;
+            }
+            if (changed && !in_run) {
+                in_run = true;
+                run_start = y;
+                run_color = color;
+            }
         }
     }
 }
 
-static boolean scene_detect_collision(scene *s, g_rect r) {
-    boolean col = false;
-    for (int i = 0; i < s->num_blocks; i++) {
-        g_rect blck_r = s->block_rects[i];
-        if (g_rect_intersects(r, blck_r)) {
-            col = true;
-            break;
+static int scene_layer_color(scene *s, gen_frame frame, const g_rect *blocks, int num_blocks, g_point p) {
+    for (int i = 0; i < num_blocks; i++) {
+        if (g_rect_contains_point(blocks[i], p)) {
+            return COL_BLCK(s);
         }
     }
-    if (col == false) {
-        col = gen_detect_collision(s->gen, r);
+    if (p.y < frame.top_height || p.y >= s->gen->size.height - frame.bottom_height) {
+        return COL_TER(s);
     }
-    return col;
+    return COL_BG(s);
 }
 
 static void scene_update_copter(scene *s, copter_direction dir) {
     if (dir == copter_up) {
-        if (++s->copter_boost > boost.max) {
-            s->copter_boost = boost.max;
+        if (++s->copter_boost > HELICOPTER_MAX_BOOST) {
+            s->copter_boost = HELICOPTER_MAX_BOOST;
         }
     } else {
         if (--s->copter_boost < 0) {
             s->copter_boost = 0;
         }
     }
-    if (++s->copter_gravity > gravity.max) {
-        s->copter_gravity = gravity.max;
+    if (++s->copter_gravity > HELICOPTER_MAX_GRAVITY) {
+        s->copter_gravity = HELICOPTER_MAX_GRAVITY;
     }
-    s->copter_pos.y += (s->copter_gravity * gravity.damping) - (s->copter_boost * boost.damping);
+    s->copter_pos.y += helicopter_dy(s->copter_gravity, s->copter_boost);
 }
@@ -8,14 +8,26 @@
 //
 // The scene is updated by calling scene_update() with the helicopter movemement 
 // direction, and callback functions can be registered to handle collision events.
+//
+// The helicopter is layered on top of the terrain and obstacles: they never draw
+// over its pixels, and the pixels it uncovers when it moves are rebuilt in the
+// color of whatever is beneath them.
+//
+// When the display can't keep up, the level of detail can be lowered to draw
+// less on each update (see scene_set_detail()) without changing how the game
+// plays.
 
 #ifndef __scene_h__
 #define __scene_h__
 #include <Arduino.h>
 #include <Adafruit_GFX.h>
 #include "generator.h"
+#include "verifier.h"
 #include "geometry.h"
 
+// The maximum number of columns that the scene can scroll in one update.
+#define SCENE_MAX_STEP 8
+
 typedef struct {
 	int background; // Color of the background of the game.
 	int terrain;	// Color of the terrain on the top and bottom.
@@ -23,29 +35,59 @@ typedef struct {
     int copter;     // Color of the copter
 } scene_colors;
 
+// How much of the scene is drawn by each update, from the most to the least.
+// Each level also leaves out what the levels before it do.
+typedef enum {
+    scene_detail_full = 0,          // Everything is drawn on every update.
+    scene_detail_no_animation,      // The blade of the copter doesn't spin.
+    scene_detail_coalesce_terrain,  // The terrain and blocks are only drawn on every
+                                    // other update, scrolling by both at once.
+    scene_detail_drop_frames        // Nothing is drawn on every other update.
+} scene_detail;
+
 typedef struct {
     Adafruit_GFX *tft;   	// Display being drawn into.
     generator *gen;			// Terrain generator.
-    gen_frame *frames;		// Array of generator frames visible on screen.
-    size_t num_frames;		// Length of `frames` array.
+    size_t num_frames;		// Number of generator frames visible on screen.
     g_rect *block_rects;	// Array of block rectangles for the obstacle blocks.
     size_t num_blocks;		// Number of blocks present (or upcoming) on screen.
-    int last_block_d;		// Distance passed since the last block was inserted.
-    int max_block_d;		// Distance between obstacle blocks.
+    size_t max_blocks;		// Capacity of `block_rects`.
     g_size block_size;		// Size of obstacle blocks.
     scene_colors colors;	// Color definitions.
     g_point copter_pos;     // Current position of the helicopter;
+    int copter_frame;       // Animation frame of the helicopter.
+    boolean copter_visible; // Whether the helicopter has been drawn since the scene was drawn.
+    g_point copter_drawn_pos;   // Position at which the helicopter is drawn.
+    int copter_drawn_frame;     // Animation frame in which the helicopter is drawn.
+    boolean copter_redrawn;     // Whether the last update redrew the helicopter.
     int copter_boost;       // Current copter boost level.
     int copter_gravity;     // Current copter gravity.
     boolean collided;       // Whether the copter is in a state of collision.
+    g_rect overlay;         // Region that the scene never draws into (e.g. the HUD).
+    int scroll_step;        // Number of columns scrolled by each update.
+    verifier *playability;  // Checks that obstacle blocks can be flown past.
+    scene_detail detail;    // How much is drawn by each update.
+    int deferred_scroll;    // Columns scrolled by updates that haven't been drawn yet.
 } scene;
 
+// Maximum number of obstacle blocks that could be present on screen at a given
+// time, which is the size of the `block_rects` array.
+#define SCENE_MAX_BLOCKS(width, blk_d, blk_width) \
+    (((width) + (blk_width) + (blk_d) - 1) / ((blk_width) + (blk_d)) * 2)
+
+// Number of bytes that scene_new() allocates from the arena, with the same
+// arguments. Used to size the arena at compile time (see arena.h).
+#define SCENE_MEMORY_BYTES(width, height, blk_d, blk_width) \
+    (ARENA_BYTES(sizeof(scene)) + \
+     ARENA_BYTES(SCENE_MAX_BLOCKS(width, blk_d, blk_width) * sizeof(g_rect)) + \
+     GEN_MEMORY_BYTES(width) + VERIFIER_MEMORY_BYTES(height))
+
 typedef enum {
     copter_up = 0,
     copter_down = 1
 } copter_direction;
 
-// Creates a new scene.
+// Creates a new scene, allocating its memory from the arena (see arena.h).
 //
 // @param tft       Pointer to the TFT display to draw the scene into.
 // @param tft_size  The size of the TFT to draw into.
@@ -57,6 +99,7 @@ typedef enum {
 // @param blk_size	Size of obstacle blocks.
 // @param colors 	`scene_color` struct containing the colors used for drawing the
 //					scene (background, terrain, etc.)
+// @param random    Random number generator used to generate the terrain and blocks.
 //
 // @return A pointer to the newly created `scene` struct.
 //
@@ -66,7 +109,59 @@ scene * scene_new(Adafruit_GFX *tft,
 	              int max_d, 
 	              int blk_d, 
 	              g_size blk_size,
-	              scene_colors colors);
+	              scene_colors colors,
+	              rng *random);
+
+// Resets the scene to the start of a new round, starting the terrain over from
+// a flat tunnel and redrawing the display outside of the overlay region. New
+// terrain scrolls in as the scene is updated. The memory allocated by
+// scene_new() is reused.
+//
+// @param s Pointer to the `scene` to reset.
+//
+void scene_reset(scene *s);
+
+// Redraws the whole scene as it is, outside of the overlay region, after
+// something else has been drawn over the display.
+//
+// @param s Pointer to the `scene` to redraw.
+//
+void scene_redraw(scene *s);
+
+// Does deferred work, such as generating upcoming terrain and checking that it
+// can be flown through, while there is time to spare. Call between updates; it
+// keeps working for as long as the display is still busy drawing the last
+// update.
+//
+// @param s Pointer to the `scene`.
+//
+void scene_idle(scene *s);
+
+// Excludes a region of the display from all terrain and block drawing so that
+// another component (e.g. the score HUD) can draw into it. Only affects drawing,
+// collisions still take the terrain under the overlay into account.
+//
+// @param s Pointer to the `scene`.
+// @param r The region to exclude. Pass an empty rect to draw everywhere.
+//
+void scene_set_overlay(scene *s, g_rect r);
+
+// Sets how many columns the scene scrolls by on each update, which sets the
+// speed of the game without updating more often. Collisions are still checked
+// at every column that is skipped over.
+//
+// @param s     Pointer to the `scene`.
+// @param step  Number of columns per update, from 1 to SCENE_MAX_STEP.
+//
+void scene_set_speed(scene *s, int step);
+
+// Sets how much of the scene is drawn by each update. The copter still moves,
+// and collisions are still checked, on every update at every level.
+//
+// @param s         Pointer to the `scene`.
+// @param detail    The level of detail.
+//
+void scene_set_detail(scene *s, scene_detail detail);
 
 // Updates the scene by drawing the next frame.
 //
@@ -0,0 +1,46 @@
+// ArduinoCopter
+// scene_config.h
+//
+// Created October 19, 2026
+//
+// Size, layout and speed of the scene on each display. Shared by the game and
+// by the benchmark in tools/avr_bench, so that the benchmark runs the same
+// scene that the game does.
+
+#ifndef __scene_config_h__
+#define __scene_config_h__
+#include "scene.h"
+
+// Size of each display. The 1.8" LCD is 128x160 in the orientation that
+// INITR_BLACKTAB sets up.
+static const int small_lcd_width = 128;
+static const int small_lcd_height = 160;
+static const int large_lcd_width = 480;
+static const int large_lcd_height = 272;
+
+// Layout of the scene: the spacing between the top and bottom terrain, how much
+// the terrain can slope from one column to the next, and the distance between
+// obstacle blocks and their size. The large display has room for a wider tunnel
+// and blocks that are further apart.
+static const int small_scene_spacing = 100;
+static const int small_scene_block_distance = 75;
+static const int large_scene_spacing = 200;
+static const int large_scene_block_distance = 125;
+static const int scene_max_delta = 1;
+static const int scene_block_width = 10;
+static const int scene_block_height = 25;
+
+// Speed of the scene, in columns scrolled per tick, at the start of a round and
+// at its fastest. The large display is slower to redraw, so it starts out
+// scrolling two columns per tick.
+static const int small_base_scroll_step = 1;
+static const int large_base_scroll_step = 2;
+static const int max_scroll_step = 3;
+
+// Memory for the scene on each display (see arena.h).
+#define SMALL_SCENE_MEMORY_BYTES SCENE_MEMORY_BYTES(small_lcd_width, small_lcd_height, \
+    small_scene_block_distance, scene_block_width)
+#define LARGE_SCENE_MEMORY_BYTES SCENE_MEMORY_BYTES(large_lcd_width, large_lcd_height, \
+    large_scene_block_distance, scene_block_width)
+
+#endif
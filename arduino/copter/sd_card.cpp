@@ -0,0 +1,111 @@
+// ArduinoCopter
+// sd_card.cpp
+//
+// Created October 19, 2026
+//
+
+#include "sd_card.h"
+
+#ifdef SD_CARD
+
+// =========== Global Variables ============
+
+static Sd2Card card;
+static SdVolume volume;
+static SdFile root;
+static uint8_t card_cs_pin;
+
+static boolean tried = false;       // Whether sd_card_init() has been called.
+static boolean ready = false;       // Whether the card and volume are set up.
+
+static boolean writing = false;     // Whether a multiple block write is open.
+static uint32_t next_write_block;   // Block that continues the open write.
+
+// =========== Public API ============
+// All Public APIs are documented in sd_card.h
+
+boolean sd_card_init(uint8_t cs_pin) {
+    if (tried) return ready;
+    tried = true;
+    card_cs_pin = cs_pin;
+
+    pinMode(cs_pin, OUTPUT);
+    digitalWrite(cs_pin, HIGH);
+
+    // The card library leaves its own SPI clock set up, so put the display's
+    // back afterwards.
+    uint8_t spcr = SPCR;
+    uint8_t spsr = SPSR;
+    ready = card.init(SPI_FULL_SPEED, cs_pin) && volume.init(&card) && root.openRoot(&volume);
+    SPCR = spcr;
+    SPSR = spsr;
+    return ready;
+}
+
+boolean sd_card_ready() {
+    return ready;
+}
+
+boolean sd_card_busy() {
+    if (!ready) return false;
+
+    // The card holds its data line low until it has finished programming.
+    digitalWrite(card_cs_pin, LOW);
+    SPDR = 0xFF;
+    while (!(SPSR & (1 << SPIF)));
+    boolean busy = SPDR != 0xFF;
+    digitalWrite(card_cs_pin, HIGH);
+    return busy;
+}
+
+boolean sd_card_open(SdFile *file, const char *name, uint8_t flags) {
+    if (!ready) return false;
+    sd_card_end_write();
+    return file->open(&root, name, flags);
+}
+
+boolean sd_card_contiguous_file(const char *name, uint32_t blocks, uint32_t *first_block) {
+    SdFile file;
+    uint32_t last_block;
+
+    // Reuse the file from the last boot if it's still good, since allocating it
+    // takes a while.
+    if (sd_card_open(&file, name, O_RDWR)) {
+        boolean reuse = file.contiguousRange(first_block, &last_block) &&
+                        last_block - *first_block + 1 >= blocks;
+        file.close();
+        if (reuse) return true;
+        SdFile::remove(&root, name);
+    }
+    if (!ready || !file.createContiguous(&root, name, blocks * 512) ||
+        !file.contiguousRange(first_block, &last_block)) {
+        return false;
+    }
+    file.close();
+    return true;
+}
+
+boolean sd_card_write_block(uint32_t block, const uint8_t *data, uint32_t count) {
+    if (!ready) return false;
+    if (writing && block != next_write_block) {
+        sd_card_end_write();
+    }
+    if (!writing) {
+        if (!card.writeStart(block, count)) return false;
+        writing = true;
+    }
+    if (!card.writeData(data)) {
+        writing = false;
+        return false;
+    }
+    next_write_block = block + 1;
+    return true;
+}
+
+boolean sd_card_end_write() {
+    if (!writing) return true;
+    writing = false;
+    return card.writeStop();
+}
+
+#endif
@@ -0,0 +1,75 @@
+// ArduinoCopter
+// sd_card.h
+//
+// Created October 19, 2026
+//
+// The SD card, shared by the SD log and the splash screens. The card sits on the
+// SPI bus next to the display and runs at the SPI clock that the display library
+// set up, so the two never have to switch settings.
+//
+// Compiled in when SD_LOG or SD_SPLASH is defined (see the Makefile), which
+// also defines SD_CARD. The SD library keeps a 512-byte block cache in SRAM.
+
+#ifndef __sd_card_h__
+#define __sd_card_h__
+#include <Arduino.h>
+
+#if defined(SD_LOG) || defined(SD_SPLASH)
+#define SD_CARD
+#endif
+
+#ifdef SD_CARD
+#include <SD.h>
+
+// Sets up the card and the FAT volume on it. The card shares the SPI bus with
+// the display, so this must be called after the display has been initialized.
+// Only the first call talks to the card.
+//
+// @param cs_pin    Chip select pin of the card.
+// @return Whether the card is ready.
+boolean sd_card_init(uint8_t cs_pin);
+
+// Returns whether sd_card_init() has succeeded.
+boolean sd_card_ready();
+
+// Returns whether the card is still programming a block it was sent, in which
+// case the next write would wait for it to finish.
+boolean sd_card_busy();
+
+// Opens a file in the root directory of the card. Finishes any write started
+// by sd_card_write_block() first.
+//
+// @param file  The file to open.
+// @param name  The 8.3 name of the file.
+// @param flags Open flags, e.g. O_READ.
+// @return Whether the file was opened.
+boolean sd_card_open(SdFile *file, const char *name, uint8_t flags);
+
+// Finds a contiguous file in the root directory, creating it (and removing any
+// file of the same name that isn't contiguous or is too small) if needed.
+//
+// @param name          The 8.3 name of the file.
+// @param blocks        Number of 512-byte blocks the file must have.
+// @param first_block   Set to the card block at which the file starts.
+// @return Whether the file is ready.
+boolean sd_card_contiguous_file(const char *name, uint32_t blocks, uint32_t *first_block);
+
+// Writes a block straight to the card. Blocks that follow on from the last one
+// written are sent as part of the same multiple block write, which is much
+// faster than writing them one by one, until sd_card_end_write() is called.
+//
+// @param block The block on the card.
+// @param data  The 512 bytes to write.
+// @param count Number of blocks that may be written from here on, which the
+//              card pre-erases when a new multiple block write starts.
+// @return Whether the block was written.
+boolean sd_card_write_block(uint32_t block, const uint8_t *data, uint32_t count);
+
+// Finishes the multiple block write in progress, if there is one.
+//
+// @return Whether the write finished cleanly.
+boolean sd_card_end_write();
+
+#endif
+
+#endif
@@ -0,0 +1,218 @@
+// ArduinoCopter
+// sd_log.cpp
+//
+// Created October 19, 2026
+//
+
+#include "sd_log.h"
+
+#ifdef SD_LOG
+
+#include "sd_card.h"
+
+// =========== Types ============
+
+// A block of records being filled in or waiting to be written.
+typedef struct {
+    uint8_t data[512];      // The block, starting with its header.
+    uint16_t length;        // Bytes used, including the header.
+    boolean full;           // Whether the block is waiting to be written.
+} sd_log_block;
+
+// =========== Function Declarations ============
+
+// Starts filling a block with the next sequence number.
+//
+// @param b Pointer to the block.
+static void sd_log_start_block(sd_log_block *b);
+
+// Adds a record to the block being filled, moving on to the other block if it
+// doesn't fit. Drops the record if both blocks are waiting to be written.
+//
+// @param record    The record.
+// @param length    The length of the record.
+static void sd_log_append(const uint8_t *record, uint8_t length);
+
+// Writes the oldest block that is waiting to be written. Waits for the card if
+// it is busy.
+static void sd_log_write_next();
+
+// Stops logging after the card has failed or the file is full.
+static void sd_log_stop();
+
+// Stores a little endian number in a buffer.
+//
+// @param p     Where to store the number.
+// @param value The number.
+static void sd_log_put16(uint8_t *p, uint16_t value);
+static void sd_log_put32(uint8_t *p, uint32_t value);
+
+// =========== Constants ============
+
+static const uint16_t block_size = 512;
+static const uint8_t header_length = 16;
+static const char file_name[] = "COPTER.LOG";
+
+// Record types.
+static const uint8_t record_round_start = 0x01;
+static const uint8_t record_tick = 0x02;
+static const uint8_t record_round_end = 0x03;
+
+// =========== Global Variables ============
+
+static boolean active = false;
+static uint32_t session_id;
+static uint32_t first_block;        // Card block at which the file starts.
+static uint32_t next_block;         // Block of the file that is written next.
+
+static sd_log_block blocks[2];
+static uint8_t current = 0;         // Index of the block being filled.
+static uint8_t write_next = 0;      // Index of the next block to write.
+static uint32_t sequence = 0;       // Sequence number of the next block.
+static uint16_t dropped = 0;        // Records dropped in the current round.
+
+// =========== Public API ============
+// All Public APIs are documented in sd_log.h
+
+boolean sd_log_init(uint32_t session) {
+    if (!sd_card_contiguous_file(file_name, SD_LOG_BLOCKS, &first_block)) {
+        return false;
+    }
+
+    session_id = session;
+    next_block = 0;
+    sequence = 0;
+    dropped = 0;
+    current = 0;
+    write_next = 0;
+    blocks[0].full = false;
+    blocks[1].full = false;
+    sd_log_start_block(&blocks[current]);
+    active = true;
+    return true;
+}
+
+void sd_log_round_start(uint32_t rng_state, uint8_t display, uint8_t scroll_step) {
+    uint8_t record[7];
+    record[0] = record_round_start;
+    sd_log_put32(record + 1, rng_state);
+    record[5] = display;
+    record[6] = scroll_step;
+    sd_log_append(record, sizeof(record));
+}
+
+void sd_log_tick(uint8_t flags, uint8_t scroll_step, uint32_t update_us, uint32_t frame_us, uint32_t score) {
+    uint8_t record[11];
+    record[0] = record_tick;
+    record[1] = flags;
+    record[2] = scroll_step;
+    sd_log_put16(record + 3, min(update_us, 0xFFFFUL));
+    sd_log_put16(record + 5, min(frame_us, 0xFFFFUL));
+    sd_log_put32(record + 7, score);
+    sd_log_append(record, sizeof(record));
+}
+
+void sd_log_round_end(uint32_t score) {
+    if (!active) return;
+
+    // Make room for the record first, so that it isn't dropped.
+    while (active && blocks[write_next].full) {
+        sd_log_write_next();
+    }
+    uint8_t record[7];
+    record[0] = record_round_end;
+    sd_log_put32(record + 1, score);
+    sd_log_put16(record + 5, dropped);
+    sd_log_append(record, sizeof(record));
+    dropped = 0;
+
+    // Write out everything, including the partly filled block, so the round is
+    // on the card before the player has a chance to switch the game off.
+    if (blocks[current].length > header_length) {
+        blocks[current].full = true;
+    }
+    while (active && blocks[write_next].full) {
+        sd_log_write_next();
+    }
+    if (active && !sd_card_end_write()) {
+        sd_log_stop();
+    }
+}
+
+void sd_log_idle() {
+    if (!active || !blocks[write_next].full || sd_card_busy()) return;
+    sd_log_write_next();
+}
+
+// =========== Private API ============
+
+static void sd_log_start_block(sd_log_block *b) {
+    memset(b->data, 0, block_size);
+    b->data[0] = 'C';
+    b->data[1] = 'P';
+    b->data[2] = 'L';
+    b->data[3] = 'G';
+    b->data[4] = SD_LOG_VERSION;
+    sd_log_put32(b->data + 8, session_id);
+    sd_log_put32(b->data + 12, sequence++);
+    b->length = header_length;
+    b->full = false;
+}
+
+static void sd_log_append(const uint8_t *record, uint8_t length) {
+    if (!active) return;
+    sd_log_block *b = &blocks[current];
+    if (b->length + length > block_size) {
+        b->full = true;
+        uint8_t other = current ^ 1;
+        if (blocks[other].full) {
+            dropped++;
+            return;
+        }
+        current = other;
+        b = &blocks[current];
+        sd_log_start_block(b);
+    }
+    memcpy(b->data + b->length, record, length);
+    b->length += length;
+}
+
+static void sd_log_write_next() {
+    sd_log_block *b = &blocks[write_next];
+    if (next_block >= SD_LOG_BLOCKS) {
+        sd_log_stop();
+        return;
+    }
+    sd_log_put16(b->data + 6, b->length - header_length);
+    if (!sd_card_write_block(first_block + next_block, b->data, SD_LOG_BLOCKS - next_block)) {
+        sd_log_stop();
+        return;
+    }
+    next_block++;
+    b->full = false;
+
+    // A block that was written before it was full (at the end of a round)
+    // starts again for the next records, and is the next to be written.
+    if (write_next == current) {
+        sd_log_start_block(b);
+    } else {
+        write_next ^= 1;
+    }
+}
+
+static void sd_log_stop() {
+    sd_card_end_write();
+    active = false;
+}
+
+static void sd_log_put16(uint8_t *p, uint16_t value) {
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+static void sd_log_put32(uint8_t *p, uint32_t value) {
+    sd_log_put16(p, value);
+    sd_log_put16(p + 2, value >> 16);
+}
+
+#endif
@@ -0,0 +1,110 @@
+// ArduinoCopter
+// sd_log.h
+//
+// Created October 19, 2026
+//
+// Logs per-tick telemetry and the input of each round to the SD card. Records
+// are packed into 512-byte blocks in RAM, and full blocks are streamed to a
+// contiguous file on the card. There are two blocks, so records keep being
+// added to one while the other waits to be written.
+//
+// Writing to the card doesn't hold up a tick: blocks are only written from
+// sd_log_idle(), once the card has finished programming the last block.
+// Blocks that follow each other are sent as one multiple block write (see
+// sd_card.h). If both blocks are full when a record arrives, the record is
+// dropped and counted in the ROUND_END record.
+//
+// Only compiled in when SD_LOG is defined (see the Makefile). The two blocks
+// and the SD library's block cache take about 1.5 KB of SRAM. Logs are read
+// on Linux with tools/sd_log_reader.py.
+//
+// ======== File Format ========
+//
+// The log is written to COPTER.LOG, which is created as a contiguous file of
+// SD_LOG_BLOCKS blocks. Each boot writes a new session from the start of the
+// file. All numbers are little endian.
+//
+// Each 512-byte block starts with a 16 byte header:
+//
+//    0  4  Magic, "CPLG"
+//    4  1  Format version, SD_LOG_VERSION
+//    5  1  Reserved, 0
+//    6  2  Number of record bytes that follow the header
+//    8  4  Session ID, which is different on every boot
+//   12  4  Sequence number of the block in the session, starting at 0
+//
+// followed by whole records (a record never spans two blocks). Each record
+// starts with its type:
+//
+// 0x01 ROUND_START  <32 bit rng state> <8 bit display> <8 bit scroll step>
+//      A round starts. The rng state is the state of the game's random number
+//      generator at the start of the round. Starting a scene from it and
+//      playing back the button and scroll step of each tick replays the round
+//      exactly, since the terrain and blocks don't depend on idle time or the
+//      level of detail (see tools/scene_check). The display is 0 for the 1.8"
+//      LCD and 1 for the 5" LCD.
+//
+// 0x02 TICK  <8 bit flags> <8 bit scroll step> <16 bit update us>
+//            <16 bit frame us> <32 bit score>
+//      A tick of the round. Bit 0 of the flags is set if the button was down
+//      and bit 1 if the copter collided. The update time covers the tick
+//      itself, and the frame time is from the start of the previous tick to
+//      the start of this one. Both saturate at 65535.
+//
+// 0x03 ROUND_END  <32 bit score> <16 bit dropped records>
+//      The round is over.
+
+#ifndef __sd_log_h__
+#define __sd_log_h__
+#include <Arduino.h>
+
+#ifdef SD_LOG
+
+// Number of 512-byte blocks in the log file (4 MB). Logging stops once the file
+// is full.
+#define SD_LOG_BLOCKS 8192
+
+// Version of the file format.
+#define SD_LOG_VERSION 1
+
+// Flags of a TICK record.
+#define SD_LOG_TICK_BUTTON      0x01
+#define SD_LOG_TICK_COLLISION   0x02
+
+// Sets up the log file on the SD card, which must have been set up with
+// sd_card_init().
+//
+// @param session   ID of the session, which should differ between boots.
+// @return Whether logging is possible. If not, the other functions do nothing.
+boolean sd_log_init(uint32_t session);
+
+// Logs the start of a round.
+//
+// @param rng_state     State of the game's random number generator.
+// @param display       0 for the 1.8" LCD, 1 for the 5" LCD.
+// @param scroll_step   Columns scrolled per tick at the start of the round.
+void sd_log_round_start(uint32_t rng_state, uint8_t display, uint8_t scroll_step);
+
+// Logs a tick of the round.
+//
+// @param flags         SD_LOG_TICK_BUTTON and/or SD_LOG_TICK_COLLISION.
+// @param scroll_step   Columns scrolled by the tick.
+// @param update_us     Time taken by the tick, in microseconds.
+// @param frame_us      Time since the start of the previous tick, in microseconds.
+// @param score         Score after the tick.
+void sd_log_tick(uint8_t flags, uint8_t scroll_step, uint32_t update_us, uint32_t frame_us, uint32_t score);
+
+// Logs the end of a round and writes everything logged so far to the card,
+// waiting for the writes to finish.
+//
+// @param score The final score.
+void sd_log_round_end(uint32_t score);
+
+// Writes a full block to the card if there is one, the SPI bus is free and the
+// card isn't busy. Otherwise the block waits for a later call. Call this
+// whenever there is time to spare between ticks.
+void sd_log_idle();
+
+#endif
+
+#endif
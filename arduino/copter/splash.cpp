@@ -0,0 +1,277 @@
+// ArduinoCopter
+// splash.cpp
+//
+// Created October 19, 2026
+//
+
+#include "splash.h"
+
+#ifdef SD_SPLASH
+
+#include "sd_card.h"
+
+// =========== Function Declarations ============
+
+// Opens the file of a splash screen and checks its header.
+//
+// @param file      The file to open.
+// @param screen    The screen.
+// @return Whether the file was opened and fits the display.
+static boolean splash_open(SdFile *file, splash_screen screen);
+
+// Sends a region of an open splash screen to the display.
+//
+// @param file  The file of the splash screen.
+// @param r     The region, which must be within the display.
+// @return Whether the region was sent. False if reading the card failed.
+static boolean splash_stream(SdFile *file, g_rect r);
+
+// Sets the address window of the display to a region and starts a write of
+// the pixels in it.
+//
+// @param r The region.
+static void splash_begin_window(g_rect r);
+
+// Sends the next pixels of the address window to the display.
+//
+// @param data      The pixels, as RGB565 with the high byte first.
+// @param length    The number of bytes to send.
+static void splash_write_pixels(const uint8_t *data, uint8_t length);
+
+// Sets the address window of the display back to the whole display.
+static void splash_end_window();
+
+// Sends a command with its arguments to the ST7735.
+//
+// @param command   The command.
+// @param args      The arguments.
+// @param num_args  The number of arguments.
+static void splash_st7735_command(uint8_t command, const uint8_t *args, uint8_t num_args);
+
+// Writes a pair of RA8875 registers holding a 16 bit value.
+//
+// @param reg   The register of the low byte. The high byte is in the next one.
+// @param value The value.
+static void splash_ra8875_write_pair(uint8_t reg, uint16_t value);
+
+// Writes a byte to the SPI bus and waits for it to be sent.
+//
+// @param b The byte.
+static void splash_spi_write(uint8_t b);
+
+// =========== Constants ============
+
+// Bytes read from the card and sent to the display at a time.
+static const uint8_t line_size = 64;
+
+static const uint8_t header_length = 8;
+
+static const char intro_name[] PROGMEM = "INTRO.RAW";
+static const char pause_name[] PROGMEM = "PAUSE.RAW";
+static const char game_over_name[] PROGMEM = "OVER.RAW";
+static const char * const file_names[] PROGMEM = {intro_name, pause_name, game_over_name};
+
+// ST7735 commands used to set the address window and write pixels.
+static const uint8_t ST7735_CASET = 0x2A;
+static const uint8_t ST7735_RASET = 0x2B;
+static const uint8_t ST7735_RAMWR = 0x2C;
+
+// RA8875 bytes that start a register select or a data write, and the
+// registers of the active window and the memory write cursor.
+static const uint8_t RA8875_CMDWRITE = 0x80;
+static const uint8_t RA8875_DATAWRITE = 0x00;
+static const uint8_t RA8875_MRWC = 0x02;
+static const uint8_t RA8875_HSAW0 = 0x30;
+static const uint8_t RA8875_VSAW0 = 0x32;
+static const uint8_t RA8875_HEAW0 = 0x34;
+static const uint8_t RA8875_VEAW0 = 0x36;
+static const uint8_t RA8875_CURH0 = 0x46;
+static const uint8_t RA8875_CURV0 = 0x48;
+
+// =========== Global Variables ============
+
+static boolean enabled = false;
+static splash_panel panel;
+static g_size panel_size;
+
+static volatile uint8_t *cs_port;
+static uint8_t cs_mask;
+static volatile uint8_t *dc_port;
+static uint8_t dc_mask;
+
+static boolean showing = false;     // Whether a splash screen is on the display.
+static splash_screen shown;         // The splash screen on the display.
+
+// =========== Public API ============
+// All Public APIs are documented in splash.h
+
+void splash_init(splash_panel p, g_size size, uint8_t cs_pin, uint8_t dc_pin) {
+    panel = p;
+    panel_size = size;
+    cs_port = portOutputRegister(digitalPinToPort(cs_pin));
+    cs_mask = digitalPinToBitMask(cs_pin);
+    if (panel == splash_panel_st7735) {
+        dc_port = portOutputRegister(digitalPinToPort(dc_pin));
+        dc_mask = digitalPinToBitMask(dc_pin);
+    }
+    enabled = true;
+}
+
+boolean splash_draw(splash_screen screen) {
+    showing = false;
+    SdFile file;
+    if (!splash_open(&file, screen)) return false;
+    showing = splash_stream(&file, (g_rect){{0, 0}, panel_size});
+    shown = screen;
+    file.close();
+    return showing;
+}
+
+boolean splash_restore(g_rect r) {
+    if (!showing) return false;
+
+    // Clip to the display.
+    int min_x = max(r.origin.x, 0);
+    int min_y = max(r.origin.y, 0);
+    int max_x = min(g_rect_maxx(r), panel_size.width);
+    int max_y = min(g_rect_maxy(r), panel_size.height);
+    if (max_x <= min_x || max_y <= min_y) return true;
+
+    SdFile file;
+    if (!splash_open(&file, shown)) return false;
+    boolean restored = splash_stream(&file, (g_rect){{min_x, min_y}, {max_x - min_x, max_y - min_y}});
+    file.close();
+    return restored;
+}
+
+// =========== Private API ============
+
+static boolean splash_open(SdFile *file, splash_screen screen) {
+    if (!enabled) return false;
+    char name[13];
+    strcpy_P(name, (const char *)pgm_read_word(&file_names[screen]));
+    if (!sd_card_open(file, name, O_READ)) return false;
+
+    uint8_t header[header_length];
+    uint16_t width = 0;
+    uint16_t height = 0;
+    if (file->read(header, header_length) == header_length && memcmp(header, "CPSP", 4) == 0) {
+        width = header[4] | (header[5] << 8);
+        height = header[6] | (header[7] << 8);
+    }
+    if (width != panel_size.width || height != panel_size.height ||
+        file->fileSize() < header_length + (uint32_t)width * height * 2) {
+        file->close();
+        return false;
+    }
+    return true;
+}
+
+static boolean splash_stream(SdFile *file, g_rect r) {
+    uint8_t line[line_size];
+    boolean whole_rows = r.size.width == panel_size.width;
+    boolean ok = true;
+
+    splash_begin_window(r);
+    for (int y = r.origin.y; y < g_rect_maxy(r) && ok; y++) {
+        // Whole rows follow on from each other in the file, so only the first
+        // one has to be looked for.
+        if (y == r.origin.y || whole_rows == false) {
+            uint32_t offset = header_length + ((uint32_t)y * panel_size.width + r.origin.x) * 2;
+            ok = file->seekSet(offset);
+        }
+        uint16_t left = r.size.width * 2;
+        while (left > 0 && ok) {
+            uint8_t count = min(left, line_size);
+            ok = file->read(line, count) == count;
+            if (ok) {
+                splash_write_pixels(line, count);
+                left -= count;
+            }
+        }
+    }
+    splash_end_window();
+    return ok;
+}
+
+static void splash_begin_window(g_rect r) {
+    int x1 = g_rect_maxx(r) - 1;
+    int y1 = g_rect_maxy(r) - 1;
+    if (panel == splash_panel_st7735) {
+        // Coordinates fit in a byte on the 128x160 display.
+        uint8_t columns[] = {0, (uint8_t)r.origin.x, 0, (uint8_t)x1};
+        uint8_t rows[] = {0, (uint8_t)r.origin.y, 0, (uint8_t)y1};
+        splash_st7735_command(ST7735_CASET, columns, sizeof(columns));
+        splash_st7735_command(ST7735_RASET, rows, sizeof(rows));
+        splash_st7735_command(ST7735_RAMWR, NULL, 0);
+    } else {
+        // Writes wrap around to the next row at the edge of the active window.
+        splash_ra8875_write_pair(RA8875_HSAW0, r.origin.x);
+        splash_ra8875_write_pair(RA8875_VSAW0, r.origin.y);
+        splash_ra8875_write_pair(RA8875_HEAW0, x1);
+        splash_ra8875_write_pair(RA8875_VEAW0, y1);
+        splash_ra8875_write_pair(RA8875_CURH0, r.origin.x);
+        splash_ra8875_write_pair(RA8875_CURV0, r.origin.y);
+        *cs_port &= ~cs_mask;
+        splash_spi_write(RA8875_CMDWRITE);
+        splash_spi_write(RA8875_MRWC);
+        *cs_port |= cs_mask;
+    }
+}
+
+static void splash_write_pixels(const uint8_t *data, uint8_t length) {
+    // The display carries on with the write when it is selected again after
+    // the card has been read.
+    *cs_port &= ~cs_mask;
+    if (panel == splash_panel_st7735) {
+        *dc_port |= dc_mask;
+    } else {
+        splash_spi_write(RA8875_DATAWRITE);
+    }
+    for (uint8_t i = 0; i < length; i++) {
+        splash_spi_write(data[i]);
+    }
+    *cs_port |= cs_mask;
+}
+
+static void splash_end_window() {
+    // The RA8875's graphics engine only draws inside the active window. The
+    // display library sets the ST7735's window for every draw.
+    if (panel == splash_panel_ra8875) {
+        splash_ra8875_write_pair(RA8875_HSAW0, 0);
+        splash_ra8875_write_pair(RA8875_VSAW0, 0);
+        splash_ra8875_write_pair(RA8875_HEAW0, panel_size.width - 1);
+        splash_ra8875_write_pair(RA8875_VEAW0, panel_size.height - 1);
+    }
+}
+
+static void splash_st7735_command(uint8_t command, const uint8_t *args, uint8_t num_args) {
+    *cs_port &= ~cs_mask;
+    *dc_port &= ~dc_mask;
+    splash_spi_write(command);
+    *dc_port |= dc_mask;
+    for (uint8_t i = 0; i < num_args; i++) {
+        splash_spi_write(args[i]);
+    }
+    *cs_port |= cs_mask;
+}
+
+static void splash_ra8875_write_pair(uint8_t reg, uint16_t value) {
+    for (uint8_t i = 0; i < 2; i++) {
+        *cs_port &= ~cs_mask;
+        splash_spi_write(RA8875_CMDWRITE);
+        splash_spi_write(reg + i);
+        *cs_port |= cs_mask;
+        *cs_port &= ~cs_mask;
+        splash_spi_write(RA8875_DATAWRITE);
+        splash_spi_write(i == 0 ? value & 0xFF : value >> 8);
+        *cs_port |= cs_mask;
+    }
+}
+
+static void splash_spi_write(uint8_t b) {
+    SPDR = b;
+    while (!(SPSR & _BV(SPIF)));
+}
+
+#endif
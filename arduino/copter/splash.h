@@ -0,0 +1,77 @@
+// ArduinoCopter
+// splash.h
+//
+// Created October 19, 2026
+//
+// Full-color splash screens for the intro, pause and Game Over screens, stored
+// on the SD card and streamed to the display. The whole screen is sent through
+// a single address window, a line buffer's worth of pixels at a time, so only
+// the line buffer sits in SRAM and the pixels go out at the speed of the bus.
+//
+// Each screen is a file in the root directory of the card:
+//
+//    INTRO.RAW     Intro screen
+//    PAUSE.RAW     Pause screen
+//    OVER.RAW      Game Over screen
+//
+// made with tools/splash_converter.py. A file starts with an 8 byte header:
+//
+//    0  4  Magic, "CPSP"
+//    4  2  Width in pixels (little endian)
+//    6  2  Height in pixels (little endian)
+//
+// followed by the pixels, row by row from the top left, as RGB565 with the high
+// byte first (the order they are sent to the display in). A screen is only
+// drawn if it is the size of the display; otherwise (or without a card) the
+// game draws its text screens instead.
+//
+// Only compiled in when SD_SPLASH is defined (see the Makefile), since the SD
+// library takes about 600 bytes of SRAM, most of it for its 512-byte block
+// cache. The card is set up with sd_card_init().
+
+#ifndef __splash_h__
+#define __splash_h__
+#include <Arduino.h>
+#include "geometry.h"
+
+typedef enum {
+    splash_intro = 0,
+    splash_pause,
+    splash_game_over
+} splash_screen;
+
+// The display controllers that splash screens can be sent to.
+typedef enum {
+    splash_panel_st7735 = 0,    // 1.8" LCD
+    splash_panel_ra8875         // 5" LCD
+} splash_panel;
+
+#ifdef SD_SPLASH
+
+// Sets up the splash screens for a display that has already been initialized.
+//
+// @param panel     The display controller.
+// @param size      The size of the display.
+// @param cs_pin    Chip select pin of the display.
+// @param dc_pin    Data/command pin of the display (unused on the RA8875).
+void splash_init(splash_panel panel, g_size size, uint8_t cs_pin, uint8_t dc_pin);
+
+// Draws a splash screen over the whole display.
+//
+// @param screen    The screen to draw.
+// @return Whether the screen was drawn. If not, the screen should be drawn some
+//         other way. The display is left alone unless reading the card failed
+//         partway through.
+boolean splash_draw(splash_screen screen);
+
+// Redraws part of the splash screen that was drawn last, e.g. to erase text
+// drawn on top of it.
+//
+// @param r The region to redraw, which is clipped to the display.
+// @return Whether the region was redrawn. False if the display isn't showing a
+//         splash screen.
+boolean splash_restore(g_rect r);
+
+#endif
+
+#endif
@@ -0,0 +1,318 @@
+// ArduinoCopter
+// verifier.cpp
+//
+// Created October 19, 2026
+//
+
+#include "verifier.h"
+#include "memory_stats.h"
+
+// =========== Function Declarations ============
+
+// The block check that a verifier sets on its generator.
+//
+// @param context   Pointer to the verifier.
+// @param index     Look-ahead index of the first frame under the block.
+// @param y         The origin y of the block.
+//
+// @return Whether the block can be flown past.
+static boolean verifier_block_check(void *context, int index, int y);
+
+// Sets the states to every y that is clear of the terrain at a position, at
+// every boost level.
+//
+// @param v Pointer to the verifier.
+// @param x Look-ahead index of the position.
+static void verifier_restart(verifier *v, int x);
+
+// Returns how many columns the next update from a position scrolls by, which
+// is less than the step if the position isn't lined up with the copter's
+// updates or if a new step applies before the end of the update.
+//
+// @param v Pointer to the verifier.
+// @param x Look-ahead index of the position.
+static int verifier_next_step(verifier *v, int x);
+
+// Moves states through an update, dropping the ones that collide at any of the
+// positions that the update sweeps over.
+//
+// @param v         Pointer to the verifier.
+// @param states    The states, which are replaced by the states after the update.
+// @param x         Look-ahead index of the position that the states are for.
+// @param step      Number of columns that the update scrolls by.
+// @param block     Look-ahead index of a block that hasn't been placed yet.
+// @param block_y   Origin y of that block, or -1 if there isn't one.
+//
+// @return Whether any states are left.
+static boolean verifier_update(verifier *v, uint8_t *states, int x, int step, int block, int block_y);
+
+// Fills a bitset with the y at which the copter is clear of the terrain, and of
+// a block that hasn't been placed yet, at every position in a range.
+//
+// @param v         Pointer to the verifier.
+// @param row       The bitset.
+// @param min_x     Look-ahead index of the first position.
+// @param max_x     Look-ahead index of the last position.
+// @param block     Look-ahead index of the block.
+// @param block_y   Origin y of the block, or -1 if there isn't one.
+static void verifier_clear_rows(verifier *v, uint8_t *row, int min_x, int max_x, int block, int block_y);
+
+// Sets or clears a range of bits in a bitset.
+//
+// @param row   The bitset.
+// @param min_y The first bit.
+// @param max_y The bit after the last bit.
+// @param value Whether to set the bits.
+static void verifier_set_range(uint8_t *row, int min_y, int max_y, boolean value);
+
+// Finds the top and bottom rows of a column of the copter.
+//
+// @param column    The column.
+// @param top       Set to the top row of the column.
+// @param bottom    Set to the bottom row of the column.
+//
+// @return Whether the column has any pixels.
+static boolean verifier_copter_rows(int column, int *top, int *bottom);
+
+// Returns the frame at a look-ahead index.
+//
+// @param v     Pointer to the verifier.
+// @param index The look-ahead index, which is negative for frames on screen.
+static gen_frame verifier_frame(verifier *v, int index);
+
+// =========== Public API ============
+// All Public APIs are documented in verifier.h
+
+verifier * verifier_new(generator *g, int max_step) {
+    verifier *v = (verifier *)MEMORY_ALLOC(memory_subsystem_verifier, sizeof(verifier));
+    v->gen = g;
+    v->step = 1;
+    v->new_step = 0;
+    v->row_bytes = VERIFIER_ROW_BYTES(g->size.height);
+    v->states = (uint8_t *)MEMORY_ALLOC(memory_subsystem_verifier, VERIFIER_BOOST_LEVELS * v->row_bytes);
+    v->trial = (uint8_t *)MEMORY_ALLOC(memory_subsystem_verifier, VERIFIER_BOOST_LEVELS * v->row_bytes);
+    v->scratch = (uint8_t *)MEMORY_ALLOC(memory_subsystem_verifier, VERIFIER_SCRATCH_ROWS * v->row_bytes);
+
+    // A block is checked until the copter is past it, which takes an update
+    // that sweeps up to a step past the end of the block with the whole width
+    // of the copter.
+    gen_set_block_check(g, verifier_block_check, v, max_step + helicopter_size.width - 1);
+    return v;
+}
+
+void verifier_reset(verifier *v, int copter_x) {
+    v->copter_x = copter_x - (int)v->gen->num_frames;
+    v->align = v->copter_x;
+    v->new_step = 0;
+    verifier_restart(v, -helicopter_size.width);
+}
+
+void verifier_set_step(verifier *v, int step, int unpopped) {
+    if (v->gen->lookahead_count == 0) {
+        v->step = step;
+        v->new_step = 0;
+        return;
+    }
+
+    // Frames up to the end of the look-ahead buffer may already have been
+    // checked with the old step, depending on how much time there was to
+    // spare, so the new step only applies after them.
+    if (v->new_step == 0) {
+        int end = GEN_LOOKAHEAD - 1 + unpopped;
+        v->step_change = end + verifier_next_step(v, end);
+    }
+    v->new_step = step;
+}
+
+void verifier_pop_frame(verifier *v) {
+    v->x--;
+    v->align--;
+    if (v->align <= v->copter_x - v->step) {
+        v->align += v->step;
+    }
+    if (v->new_step != 0) {
+        v->step_change--;
+        if (v->x >= v->step_change) {
+            v->step = v->new_step;
+            v->align = v->step_change;
+            v->new_step = 0;
+        }
+    }
+
+    // Frames on screen are slower to look up, so states that have fallen well
+    // behind the right edge are moved forwards. Starting them over instead
+    // would make the blocks depend on when the states were last moved.
+    while (v->x < -(int)(v->gen->num_frames / 2) && verifier_advance(v));
+}
+
+boolean verifier_advance(verifier *v) {
+    // The update sweeps the copter over the columns up to a step ahead.
+    int step = verifier_next_step(v, v->x);
+    if (v->x + step + helicopter_size.width > gen_num_decided(v->gen)) {
+        return false;
+    }
+    if (!verifier_update(v, v->states, v->x, step, -1, -1)) {
+        // The terrain past the frames that the last block was checked against
+        // can still leave no way through, so start over.
+        verifier_restart(v, v->x + step);
+        return true;
+    }
+    v->x += step;
+    return true;
+}
+
+boolean verifier_check_block(verifier *v, int index, int y) {
+    // Bring the states up to the block, which is as far as the decided frames go.
+    while (verifier_advance(v));
+
+    // Try out the block on a copy of the states, moving them through all of the
+    // frames generated so far, which run past the end of the block. The block
+    // is kept if any of the states make it.
+    memcpy(v->trial, v->states, VERIFIER_BOOST_LEVELS * v->row_bytes);
+    int x = v->x;
+    int step = verifier_next_step(v, x);
+    while (x + step + helicopter_size.width <= v->gen->lookahead_count) {
+        if (!verifier_update(v, v->trial, x, step, index, y)) {
+            return false;
+        }
+        x += step;
+        step = verifier_next_step(v, x);
+    }
+    uint8_t *states = v->states;
+    v->states = v->trial;
+    v->trial = states;
+    v->x = x;
+    return true;
+}
+
+void verifier_free(verifier *v) {
+    MEMORY_FREE(memory_subsystem_verifier, v->scratch, VERIFIER_SCRATCH_ROWS * v->row_bytes);
+    MEMORY_FREE(memory_subsystem_verifier, v->trial, VERIFIER_BOOST_LEVELS * v->row_bytes);
+    MEMORY_FREE(memory_subsystem_verifier, v->states, VERIFIER_BOOST_LEVELS * v->row_bytes);
+    MEMORY_FREE(memory_subsystem_verifier, v, sizeof(verifier));
+}
+
+// =========== Private API ============
+
+static boolean verifier_block_check(void *context, int index, int y) {
+    return verifier_check_block((verifier *)context, index, y);
+}
+
+static void verifier_restart(verifier *v, int x) {
+    uint8_t bytes = v->row_bytes;
+    verifier_clear_rows(v, v->states, x, x, -1, -1);
+    for (int b = 1; b < VERIFIER_BOOST_LEVELS; b++) {
+        memcpy(v->states + b * bytes, v->states, bytes);
+    }
+    v->x = x;
+}
+
+static int verifier_next_step(verifier *v, int x) {
+    // The states are always ahead of the copter, and so of `align`.
+    if (v->new_step != 0 && x >= v->step_change) {
+        return v->new_step - (x - v->step_change) % v->new_step;
+    }
+    int step = v->step - (x - v->align) % v->step;
+    if (v->new_step != 0) {
+        step = min(step, v->step_change - x);
+    }
+    return step;
+}
+
+static boolean verifier_update(verifier *v, uint8_t *states, int x, int step, int block, int block_y) {
+    uint8_t bytes = v->row_bytes;
+    uint8_t *clear = v->scratch;
+    uint8_t *below = clear + bytes;     // The level below, before the update.
+    uint8_t *level = below + bytes;     // This level, before the update.
+    verifier_clear_rows(v, clear, x + 1, x + step, block, block_y);
+
+    uint8_t any = 0;
+    for (int b = 0; b < VERIFIER_BOOST_LEVELS; b++) {
+        uint8_t *row = states + b * bytes;
+        memcpy(level, row, bytes);
+
+        // The boost goes up a level while the copter is moving up and down a
+        // level otherwise, stopping at either end.
+        const uint8_t *from_below = b == 0 ? level : below;
+        const uint8_t *from_above = b == VERIFIER_BOOST_LEVELS - 1 ? level : row + bytes;
+
+        // Then every state at this level moves by the same number of rows.
+        int dy = helicopter_dy(HELICOPTER_MAX_GRAVITY, b);
+        for (uint8_t i = 0; i < bytes; i++) {
+            uint8_t moved;
+            if (dy >= 0) {
+                moved = (from_below[i] | from_above[i]) << dy;
+                if (i > 0) moved |= (from_below[i - 1] | from_above[i - 1]) >> (8 - dy);
+            } else {
+                moved = (from_below[i] | from_above[i]) >> -dy;
+                if (i + 1 < bytes) moved |= (from_below[i + 1] | from_above[i + 1]) << (8 + dy);
+            }
+            row[i] = moved & clear[i];
+            any |= row[i];
+        }
+
+        uint8_t *t = below;
+        below = level;
+        level = t;
+    }
+    return any != 0;
+}
+
+static void verifier_clear_rows(verifier *v, uint8_t *row, int min_x, int max_x, int block, int block_y) {
+    int height = v->gen->size.height;
+    g_size block_size = v->gen->block_size;
+
+    // The terrain leaves a single range of y clear, and the block takes a
+    // single range out of it. Gaps between the pixels of a column of the copter
+    // are too small for a block to fit in.
+    int min_y = 0;
+    int max_y = height;
+    int block_min_y = height;
+    int block_max_y = 0;
+    for (int c = 0; c < helicopter_size.width; c++) {
+        int top, bottom;
+        if (!verifier_copter_rows(c, &top, &bottom)) continue;
+
+        for (int x = min_x + c; x <= max_x + c; x++) {
+            gen_frame f = verifier_frame(v, x);
+            min_y = max(min_y, f.top_height - top);
+            max_y = min(max_y, height - f.bottom_height - bottom);
+            if (block_y >= 0 && x >= block && x < block + block_size.width) {
+                block_min_y = min(block_min_y, block_y - bottom);
+                block_max_y = max(block_max_y, block_y + block_size.height - top);
+            }
+        }
+    }
+
+    memset(row, 0, v->row_bytes);
+    verifier_set_range(row, max(min_y, 0), min(max_y, height), true);
+    verifier_set_range(row, max(block_min_y, 0), min(block_max_y, height), false);
+}
+
+static void verifier_set_range(uint8_t *row, int min_y, int max_y, boolean value) {
+    for (int y = min_y; y < max_y; y++) {
+        if ((y & 7) == 0 && y + 8 <= max_y) {
+            row[y >> 3] = value ? 0xFF : 0;
+            y += 7;
+        } else if (value) {
+            row[y >> 3] |= 1 << (y & 7);
+        } else {
+            row[y >> 3] &= ~(1 << (y & 7));
+        }
+    }
+}
+
+static boolean verifier_copter_rows(int column, int *top, int *bottom) {
+    uint8_t mask = helicopter_mask(column);
+    if (mask == 0) return false;
+
+    *top = 0;
+    while (((mask >> *top) & 1) == 0) (*top)++;
+    *bottom = 7;
+    while (((mask >> *bottom) & 1) == 0) (*bottom)--;
+    return true;
+}
+
+static gen_frame verifier_frame(verifier *v, int index) {
+    return gen_frame_at(v->gen, (int)v->gen->num_frames + index);
+}
@@ -0,0 +1,128 @@
+// ArduinoCopter
+// verifier.h
+//
+// Created October 19, 2026
+//
+// Playability verifier for the terrain and obstacle blocks coming up in the
+// generator's look-ahead buffer. It keeps track of every state that the copter
+// could be in at a position in the look-ahead buffer (its y and boost level),
+// moving them through updates with the physics of the copter and dropping the
+// ones that collide. Before the generator places a block, the states are moved
+// past the block and through the frames generated after it; if none of them
+// make it, the block can't be flown past and the generator tries another
+// position for it.
+//
+// The states are kept as a bitset of y for each boost level, so moving all of
+// them through an update is a few shifts and ORs for each byte. Collisions are
+// checked against the pixel mask of the copter in every column, like the scene
+// does. Gravity is left out of the states: it builds up to its maximum within
+// the first few updates of a round and stays there. Updates are taken to scroll
+// by the scene's step, at the same columns as the copter's updates.
+//
+// The states are moved forwards when there is time to spare, as far as the
+// look-ahead buffer allows, so checking a block usually only has to move them
+// past that block. How far they have been moved never changes which blocks pass
+// the check: a new step only applies to frames past the end of the look-ahead
+// buffer (which haven't been generated yet), and states that fall behind are
+// moved forwards rather than started over. So the same random numbers and
+// input always give the same terrain, however much time there is to spare.
+
+#ifndef __verifier_h__
+#define __verifier_h__
+#include <Arduino.h>
+#include "generator.h"
+#include "helicopter.h"
+
+// Number of boost levels that states are kept for.
+#define VERIFIER_BOOST_LEVELS (HELICOPTER_MAX_BOOST + 1)
+
+// Size of a bitset of y for a region `height` pixels high.
+#define VERIFIER_ROW_BYTES(height) (((height) + 7) / 8)
+
+// Number of bitsets used while moving states through an update.
+#define VERIFIER_SCRATCH_ROWS 3
+
+typedef struct {
+    generator *gen;         // Generator of the terrain and blocks being checked.
+    int x;                  // Look-ahead index of the copter position that the
+                            // states are for, negative if it's on screen.
+    int step;               // Number of columns scrolled by each update.
+    int align;              // Look-ahead index that an update starts at.
+    int new_step;           // Step that takes over at `step_change`, or 0 if none.
+    int step_change;        // Look-ahead index from which `new_step` applies.
+    int copter_x;           // Look-ahead index of the copter's position.
+    uint8_t row_bytes;      // Size of a bitset of y, one bit per row of the region.
+    uint8_t *states;        // Bitset of y for each boost level.
+    uint8_t *trial;         // States while a block is being checked.
+    uint8_t *scratch;       // Bitsets used while moving states through an update.
+} verifier;
+
+// Number of bytes that verifier_new() allocates from the arena for a region
+// `height` pixels high.
+#define VERIFIER_MEMORY_BYTES(height) \
+    (ARENA_BYTES(sizeof(verifier)) + \
+     2 * ARENA_BYTES(VERIFIER_BOOST_LEVELS * VERIFIER_ROW_BYTES(height)) + \
+     ARENA_BYTES(VERIFIER_SCRATCH_ROWS * VERIFIER_ROW_BYTES(height)))
+
+// Creates a verifier and sets it as the block check of a generator. It has to
+// be reset with verifier_reset() before it is used.
+//
+// @param g         Pointer to the generator.
+// @param max_step  The largest number of columns that an update can scroll by.
+//
+// @return A pointer to the newly created `verifier` struct.
+verifier * verifier_new(generator *g, int max_step);
+
+// Starts the verifier over with the frames that the generator has now, e.g.
+// after gen_reset(). The copter is taken to be able to be anywhere that is clear
+// of the terrain just inside the right edge of the region.
+//
+// @param v         Pointer to the verifier.
+// @param copter_x  Screen x of the copter, which the updates are lined up with.
+void verifier_reset(verifier *v, int copter_x);
+
+// Sets how many columns each update scrolls by. At the start of a round, before
+// any frames have been generated, this applies right away. Later on, it applies
+// from the first update past the end of the look-ahead buffer, and the update
+// before it is shortened to line it up. If a new step is already waiting to
+// apply, it is replaced.
+//
+// Columns that have been scrolled but whose frames haven't been popped yet
+// still count, so that the step changes at the same column of the terrain
+// whether or not the scene deferred its last update.
+//
+// @param v         Pointer to the verifier.
+// @param step      Number of columns, up to the `max_step` passed to verifier_new().
+// @param unpopped  Number of columns scrolled whose frames haven't been popped.
+void verifier_set_step(verifier *v, int step, int unpopped);
+
+// Lets the verifier know that a frame has been popped from the generator. Must
+// be called after every call to gen_pop_frame().
+//
+// @param v Pointer to the verifier.
+void verifier_pop_frame(verifier *v);
+
+// Moves the states through one update, if the frames it covers have been
+// generated and their blocks decided.
+//
+// @param v Pointer to the verifier.
+//
+// @return Whether the states were moved.
+boolean verifier_advance(verifier *v);
+
+// Checks whether a block can be flown past. If it can, the states are moved
+// past the block.
+//
+// @param v     Pointer to the verifier.
+// @param index Look-ahead index of the first frame under the block.
+// @param y     The origin y of the block.
+//
+// @return Whether any of the states make it past the block.
+boolean verifier_check_block(verifier *v, int index, int y);
+
+// Frees all memory associated with the verifier.
+//
+// @param v Pointer to the verifier.
+void verifier_free(verifier *v);
+
+#endif
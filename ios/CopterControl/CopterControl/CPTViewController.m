@@ -15,6 +15,7 @@
 @property (nonatomic, strong, readonly) NSMutableData *buffer;
 @property (nonatomic, assign) NSUInteger score;
 @property (nonatomic, assign) NSUInteger highScore;
+@property (nonatomic, assign) uint8_t buttonSequence;
 
 @property (nonatomic, weak) IBOutlet UILabel *scoreLabel;
 @property (nonatomic, weak) IBOutlet UILabel *highScoreLabel;
@@ -136,11 +137,30 @@
 // 6) SEND: Update high score.
 //    Byte sequence: 0x05 <32 bit integer>
 //
+// (7 and 8 set up the serial link to the bridge and never reach the controller.)
+//
+// 9) SEND: Ping.
+//    Byte sequence: 0x09 <8 bit sequence number> <32 bit game timestamp>
+//
+// 10) RECEIVE: Pong, answering a ping.
+//    Byte sequence: 0x0A <8 bit sequence number of the ping>
+//                   <32 bit game timestamp of the ping> <32 bit controller timestamp>
+//
+// 11) RECEIVE: Sequenced button press down or up.
+//    Byte sequence: 0x0B <8 bit sequence number> <0x01 for down, 0x00 for up>
+//
 
 - (void)handleReceivedData:(NSData *)data
 {
 	[self.buffer appendData:data];
 	
+	// Several commands can arrive together, so keep going until the buffer is
+	// empty or only has part of a command in it.
+	while (self.buffer.length > 0 && [self handleNextCommand]) {}
+}
+
+- (BOOL)handleNextCommand
+{
 	unsigned char byte;
 	const NSRange byteRange = NSMakeRange(0, 1);
 	[self.buffer getBytes:&byte range:byteRange];
@@ -149,21 +169,42 @@
 	
 	if (score || highScore) {
 		const int totalLength = sizeof(uint32_t) + 1;
-		if (self.buffer.length >= totalLength) {
-			uint32_t val = [self readUInt32FromBuffer];
-			if (score) {
-				self.score = val;
-			} else {
-				self.highScore = val;
-			}
+		if (self.buffer.length < totalLength) return NO;
+		uint32_t val = [self readUInt32FromBuffer];
+		if (score) {
+			self.score = val;
+		} else {
+			self.highScore = val;
 		}
+	} else if (byte == 0x09) {
+		const NSUInteger pingLength = sizeof(uint32_t) + 2;
+		if (self.buffer.length < pingLength) return NO;
+		[self answerPing];
 	} else {
 		if (byte == 0x03) {
 			self.playPauseButton.selected = NO;
 			self.score = 0;
 		}
-		self.buffer.length = 0;
+		[self.buffer replaceBytesInRange:byteRange withBytes:NULL length:0];
+	}
+	return YES;
+}
+
+- (void)answerPing
+{
+	// The pong echoes the sequence number and game timestamp of the ping, followed
+	// by the time on this device in milliseconds.
+	const NSUInteger pingLength = sizeof(uint32_t) + 2;
+	unsigned char bytes[sizeof(uint32_t) * 2 + 2];
+	[self.buffer getBytes:bytes range:NSMakeRange(0, pingLength)];
+	[self.buffer replaceBytesInRange:NSMakeRange(0, pingLength) withBytes:NULL length:0];
+	
+	bytes[0] = 0x0A;
+	uint32_t time = (uint32_t)([NSProcessInfo processInfo].systemUptime * 1000.0);
+	for (NSUInteger i = 0; i < sizeof(uint32_t); i++) {
+		bytes[pingLength + i] = (time >> (8 * i)) & 0xFF;
 	}
+	[self.bluetoothManager writeBytes:bytes length:sizeof(bytes)];
 }
 
 - (uint32_t)readUInt32FromBuffer
@@ -201,14 +242,14 @@
 
 - (IBAction)buttonDown:(id)sender
 {
-	const unsigned char bytes[] = {0x01, 0x01};
-	[self.bluetoothManager writeBytes:bytes length:2];
+	const unsigned char bytes[] = {0x0B, self.buttonSequence++, 0x01};
+	[self.bluetoothManager writeBytes:bytes length:3];
 }
 
 - (IBAction)buttonUp:(id)sender
 {
-	const unsigned char bytes[] = {0x01, 0x00};
-	[self.bluetoothManager writeBytes:bytes length:2];
+	const unsigned char bytes[] = {0x0B, self.buttonSequence++, 0x00};
+	[self.bluetoothManager writeBytes:bytes length:3];
 }
 
 - (IBAction)playPause:(UIButton *)sender
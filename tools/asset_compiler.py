@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+# ArduinoCopter
+# asset_compiler.py
+#
+# Created October 19, 2026
+#
+# Compiles the text asset sources in arduino/copter/assets into packed
+# PROGMEM data, so that sprites, fonts, images and strings are read straight
+# from flash instead of taking up SRAM. Writes assets.h and assets.cpp, which
+# are checked in so that the game builds without running this tool.
+#
+# Usage: asset_compiler.py <assets dir> <output dir>
+#
+# ======== Source Format ========
+#
+# Lines starting with # are comments. Pixel rows use '.' for a clear pixel and
+# any other character for a set pixel (or a palette entry for images).
+#
+# sprite <name>         A 1bpp sprite, stored as one column at a time with the
+# <rows>                top row in the least significant bit. Columns of more
+# end                   than 8 rows take one byte per 8 rows, top rows first.
+#
+# font <name>           A set of 1bpp glyphs of the same size, stored like
+# glyph <label>         sprites. A label that is a name (rather than e.g. a
+# <rows>                digit) also gets a #define of the glyph index.
+# ...
+# end
+#
+# image <name>          A run-length encoded color image. Pixels are stored row
+# palette <char> <rgb565>   by row as (count, palette index) byte pairs, and
+# <rows>                runs may continue from one row onto the next.
+# end
+#
+# string <name> "<text>"    A string, with C escapes.
+
+import os
+import re
+import sys
+
+HEADER = """// ArduinoCopter
+// {name}
+//
+// Generated by tools/asset_compiler.py from the files in assets/.
+// Do not edit; change the assets and run `make assets` instead.
+//
+"""
+
+
+class AssetError(Exception):
+    pass
+
+
+def pack_columns(rows, width):
+    """Packs rows of pixels into column bytes, top row in the lowest bit."""
+    height = len(rows)
+    data = []
+    for x in range(width):
+        for band in range(0, height, 8):
+            byte = 0
+            for bit in range(min(8, height - band)):
+                if rows[band + bit][x] != '.':
+                    byte |= 1 << bit
+            data.append(byte)
+    return data
+
+
+def encode_rle(rows, palette):
+    """Encodes rows of palette characters as (count, index) pairs."""
+    pixels = ''.join(rows)
+    data = []
+    i = 0
+    while i < len(pixels):
+        ch = pixels[i]
+        if ch not in palette:
+            raise AssetError("'%s' is not in the palette" % ch)
+        count = 1
+        while i + count < len(pixels) and pixels[i + count] == ch and count < 255:
+            count += 1
+        data += [count, palette[ch][0]]
+        i += count
+    return data
+
+
+def check_rows(rows, name):
+    if not rows:
+        raise AssetError('%s has no pixels' % name)
+    width = len(rows[0])
+    if any(len(row) != width for row in rows):
+        raise AssetError('rows of %s differ in width' % name)
+    return width, len(rows)
+
+
+def format_bytes(data, per_line=12):
+    lines = []
+    for i in range(0, len(data), per_line):
+        lines.append('    ' + ', '.join('0x%02X' % b for b in data[i:i + per_line]))
+    return ',\n'.join(lines)
+
+
+def parse(path):
+    """Returns a list of (kind, name, fields) tuples from an asset source."""
+    assets = []
+    current = None
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            line = line.rstrip('\n')
+            where = '%s:%d' % (path, number)
+            if not line.strip() or line.startswith('#') and current is None:
+                continue
+            words = line.split()
+            try:
+                if current is None:
+                    kind = words[0]
+                    if kind == 'string':
+                        m = re.match(r'string\s+(\w+)\s+"(.*)"\s*$', line)
+                        if not m:
+                            raise AssetError('expected string <name> "<text>"')
+                        text = m.group(2).encode('latin-1').decode('unicode_escape')
+                        assets.append(('string', m.group(1), {'text': text}))
+                    elif kind in ('sprite', 'font', 'image') and len(words) == 2:
+                        current = (kind, words[1], {'rows': [], 'glyphs': [], 'palette': {}})
+                    else:
+                        raise AssetError('unknown asset "%s"' % line)
+                elif words == ['end']:
+                    assets.append(current)
+                    current = None
+                elif current[0] == 'font' and words[0] == 'glyph':
+                    current[2]['glyphs'].append((words[1], []))
+                elif current[0] == 'image' and words[0] == 'palette':
+                    palette = current[2]['palette']
+                    palette[words[1]] = (len(palette), int(words[2], 0))
+                elif current[0] == 'font':
+                    if not current[2]['glyphs']:
+                        raise AssetError('pixels before the first glyph')
+                    current[2]['glyphs'][-1][1].append(line)
+                else:
+                    current[2]['rows'].append(line)
+            except (AssetError, IndexError, ValueError) as e:
+                raise AssetError('%s: %s' % (where, e))
+    if current is not None:
+        raise AssetError('%s: %s is missing "end"' % (path, current[1]))
+    return assets
+
+
+def compile_asset(kind, name, fields):
+    """Returns the (declarations, definitions) for an asset."""
+    upper = name.upper()
+    decl = []
+    defs = []
+    if kind == 'sprite':
+        width, height = check_rows(fields['rows'], name)
+        data = pack_columns(fields['rows'], width)
+        decl += ['#define %s_WIDTH %d' % (upper, width),
+                 '#define %s_HEIGHT %d' % (upper, height),
+                 'extern const uint8_t %s[] PROGMEM;' % name]
+        defs += ['const uint8_t %s[] PROGMEM = {\n%s\n};' % (name, format_bytes(data))]
+    elif kind == 'font':
+        glyphs = fields['glyphs']
+        if not glyphs:
+            raise AssetError('%s has no glyphs' % name)
+        size = check_rows(glyphs[0][1], name)
+        rows = []
+        for index, (label, glyph_rows) in enumerate(glyphs):
+            if check_rows(glyph_rows, name) != size:
+                raise AssetError('glyph %s of %s differs in size' % (label, name))
+            data = pack_columns(glyph_rows, size[0])
+            rows.append('    {%s}' % ', '.join('0x%02X' % b for b in data))
+            if re.match(r'[A-Za-z_]\w*$', label):
+                decl.append('#define %s_%s %d' % (upper, label.upper(), index))
+        bytes_per_glyph = size[0] * ((size[1] + 7) // 8)
+        decl += ['#define %s_WIDTH %d' % (upper, size[0]),
+                 '#define %s_HEIGHT %d' % (upper, size[1]),
+                 '#define %s_COUNT %d' % (upper, len(glyphs)),
+                 'extern const uint8_t %s[][%d] PROGMEM;' % (name, bytes_per_glyph)]
+        defs += ['const uint8_t %s[][%d] PROGMEM = {\n%s\n};' % (name, bytes_per_glyph, ',\n'.join(rows))]
+    elif kind == 'image':
+        width, height = check_rows(fields['rows'], name)
+        palette = fields['palette']
+        if len(palette) > 256:
+            raise AssetError('%s has more than 256 colors' % name)
+        data = encode_rle(fields['rows'], palette)
+        colors = [color for _, color in sorted(palette.values())]
+        decl += ['#define %s_WIDTH %d' % (upper, width),
+                 '#define %s_HEIGHT %d' % (upper, height),
+                 '#define %s_RUNS %d' % (upper, len(data) // 2),
+                 'extern const uint16_t %s_palette[] PROGMEM;' % name,
+                 'extern const uint8_t %s[] PROGMEM;' % name]
+        defs += ['const uint16_t %s_palette[] PROGMEM = {%s};' % (name, ', '.join('0x%04X' % c for c in colors)),
+                 'const uint8_t %s[] PROGMEM = {\n%s\n};' % (name, format_bytes(data))]
+    elif kind == 'string':
+        literal = fields['text'].encode('unicode_escape').decode('ascii').replace('"', '\\"')
+        decl += ['extern const char %s[] PROGMEM;' % name]
+        defs += ['const char %s[] PROGMEM = "%s";' % (name, literal)]
+    return decl, defs
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write('usage: %s <assets dir> <output dir>\n' % argv[0])
+        return 2
+    source_dir, output_dir = argv[1], argv[2]
+
+    header = [HEADER.format(name='assets.h'),
+              '#ifndef __assets_h__', '#define __assets_h__', '#include <Arduino.h>', '']
+    source = [HEADER.format(name='assets.cpp'), '#include "assets.h"', '']
+    try:
+        for filename in sorted(os.listdir(source_dir)):
+            if not filename.endswith('.txt'):
+                continue
+            header.append('// ' + '=' * 11 + ' %s ' % filename + '=' * 12)
+            header.append('')
+            source.append('// ' + '=' * 11 + ' %s ' % filename + '=' * 12)
+            source.append('')
+            for kind, name, fields in parse(os.path.join(source_dir, filename)):
+                decl, defs = compile_asset(kind, name, fields)
+                # Strings are declared one per line, everything else is
+                # separated by a blank line.
+                header += decl + ([] if kind == 'string' else [''])
+                source += defs + ([] if kind == 'string' else [''])
+            if header[-1] != '':
+                header.append('')
+                source.append('')
+    except (AssetError, IOError) as e:
+        sys.stderr.write('asset_compiler: %s\n' % e)
+        return 1
+    header.append('#endif')
+
+    with open(os.path.join(output_dir, 'assets.h'), 'w') as f:
+        f.write('\n'.join(header) + '\n')
+    with open(os.path.join(output_dir, 'assets.cpp'), 'w') as f:
+        f.write('\n'.join(source).rstrip('\n') + '\n')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,196 @@
+// ArduinoCopter
+// bench_main.cpp
+//
+// Created October 19, 2026
+//
+// Benchmark firmware for tools/avr_bench. Runs the game core (scene, generator
+// and drawing) on an ATmega2560 under simavr without the intro and Game Over
+// screens, the HUD or the Bluetooth link.
+//
+// The session is set up by a line sent over Serial by bench_runner:
+//
+//     <seed> <ticks> <speed> <display>\n
+//
+// where <display> is 0 for the 1.8" ST7735 or 1 for the 5" RA8875, both drawn
+// through the display stub below. Each tick marks bench_stage_tick, at which
+// point the runner sets the button for the tick, then runs a scene update
+// exactly like the game does. A collision resets the scene and the session
+// carries on. Stage markers (see bench_stages.h) let the runner count the
+// cycles spent in each stage.
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <avr/sleep.h>
+#include "scene.h"
+#include "scene_config.h"
+#include "rng.h"
+#include "memory_stats.h"
+#include "arena.h"
+#include "bench_stages.h"
+#include "colors.h"
+
+// =========== Pin Configuration ============
+
+// Same button pin as the game, so the runner drives the same port.
+static const int BTN = 9;
+
+// Chip select and data/command of the stub display.
+static const int TFT_CS = 6;
+static const int TFT_DC = 7;
+
+// =========== Constants ============
+
+// Bytes sent over SPI for each drawing call on the RA8875 stub. The RA8875
+// fills rects with its graphics engine, so a call costs about the same
+// number of register writes no matter how many pixels it covers.
+static const uint8_t ra8875_fill_bytes = 40;
+static const uint8_t ra8875_pixel_bytes = 12;
+
+// Bytes sent over SPI for each drawing call on the ST7735 stub: the address
+// window (CASET and RASET with their arguments, then RAMWR), followed by two
+// bytes for every pixel covered.
+static const uint8_t st7735_window_bytes = 11;
+static const uint8_t st7735_bytes_per_pixel = 2;
+
+// =========== Types ============
+
+// A display that only sends bytes over SPI, standing in for the ST7735 or the
+// RA8875. Nothing is listening on the other end; the runner answers each byte
+// after the time the SPI hardware would take.
+class BenchDisplay : public Adafruit_GFX {
+public:
+	BenchDisplay(int16_t w, int16_t h, boolean hardware_fill) : Adafruit_GFX(w, h), hardware_fill(hardware_fill) {}
+
+	void drawPixel(int16_t x, int16_t y, uint16_t color) {
+		send(hardware_fill ? ra8875_pixel_bytes : st7735_window_bytes + st7735_bytes_per_pixel);
+	}
+	void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+		fill(h);
+	}
+	void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+		fill(w);
+	}
+	void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+		fill((uint32_t)w * h);
+	}
+
+private:
+	boolean hardware_fill;	// Whether rects are filled by the display (the RA8875).
+
+	void fill(uint32_t pixels) {
+		send(hardware_fill ? ra8875_fill_bytes : st7735_window_bytes + pixels * st7735_bytes_per_pixel);
+	}
+
+	void send(uint32_t count) {
+		while (count--) {
+			SPDR = 0;
+			while (!(SPSR & _BV(SPIF)));
+		}
+	}
+};
+
+// =========== Global Variables ============
+
+static BenchDisplay small_tft(small_lcd_width, small_lcd_height, false);
+static BenchDisplay large_tft(large_lcd_width, large_lcd_height, true);
+static rng bench_rng;
+
+// Memory for the scene, sized for the large display, which needs the most.
+static ARENA_BUFFER(bench_memory, LARGE_SCENE_MEMORY_BYTES);
+
+// =========== Function Declarations ============
+
+// Reads an unsigned number from Serial, skipping any spaces before it.
+static uint32_t read_number();
+
+// Sets up the SPI hardware the way the display libraries do.
+static void spi_init();
+
+// =========== Function Implementations ============
+
+void setup() {
+	Serial.begin(115200);
+	pinMode(BTN, INPUT);
+	digitalWrite(BTN, HIGH);
+	spi_init();
+	arena_init(bench_memory, sizeof(bench_memory));
+
+	uint32_t seed = read_number();
+	uint32_t ticks = read_number();
+	int speed = read_number();
+	boolean large = read_number() != 0;
+	rng_seed(&bench_rng, seed);
+
+	scene_colors colors;
+	colors.terrain = TFT_GREEN;
+	colors.background = TFT_BLACK;
+	colors.blocks = TFT_YELLOW;
+	colors.copter = TFT_WHITE;
+
+	// The same scene as the game uses for each display (see scene_config.h).
+	scene *s;
+	g_size block_size = (g_size){scene_block_width, scene_block_height};
+	if (large) {
+		s = scene_new(&large_tft, (g_size){large_lcd_width, large_lcd_height}, large_scene_spacing,
+			scene_max_delta, large_scene_block_distance, block_size, colors, &bench_rng);
+	} else {
+		s = scene_new(&small_tft, (g_size){small_lcd_width, small_lcd_height}, small_scene_spacing,
+			scene_max_delta, small_scene_block_distance, block_size, colors, &bench_rng);
+	}
+	scene_set_speed(s, speed);
+
+	uint32_t collisions = 0;
+	for (uint32_t tick = 0; tick < ticks; tick++) {
+		BENCH_STAGE(bench_stage_tick);
+		copter_direction dir = (digitalRead(BTN) == LOW) ? copter_up : copter_down;
+		if (scene_update(s, dir)) {
+			collisions++;
+			scene_reset(s);
+			scene_set_speed(s, speed);
+		}
+		BENCH_STAGE(bench_stage_idle);
+		scene_idle(s);
+		BENCH_STAGE(bench_stage_none);
+	}
+
+	Serial.print("collisions:");
+	Serial.println(collisions);
+	memory_print(&Serial);
+	Serial.flush();
+	BENCH_STAGE(bench_stage_done);
+
+	// Sleeping with interrupts disabled ends the simulation.
+	cli();
+	sleep_enable();
+	sleep_cpu();
+}
+
+void loop() {
+}
+
+static uint32_t read_number() {
+	uint32_t value = 0;
+	boolean started = false;
+	while (true) {
+		while (Serial.available() == 0);
+		char c = Serial.read();
+		if (c >= '0' && c <= '9') {
+			value = value * 10 + (c - '0');
+			started = true;
+		} else if (started) {
+			return value;
+		}
+	}
+}
+
+static void spi_init() {
+	// SS has to be an output for the SPI to stay in master mode.
+	pinMode(SS, OUTPUT);
+	pinMode(SCK, OUTPUT);
+	pinMode(MOSI, OUTPUT);
+	pinMode(TFT_CS, OUTPUT);
+	pinMode(TFT_DC, OUTPUT);
+	digitalWrite(TFT_CS, HIGH);
+	SPCR = _BV(SPE) | _BV(MSTR);
+	SPSR = _BV(SPI2X);
+}
@@ -0,0 +1,340 @@
+// ArduinoCopter
+// bench_runner.c
+//
+// Created October 19, 2026
+//
+// Runs the benchmark firmware (bench_main.cpp) under simavr and reports the
+// cycles spent in each stage of a tick, along with the deepest the stack got.
+//
+// Usage: bench_runner <firmware.elf> <session file>
+//
+// ======== Session Format ========
+//
+// Lines starting with # are comments.
+//
+// seed <n>             Seed of the terrain generator.
+// ticks <n>            Number of ticks to run.
+// speed <n>            Columns scrolled per tick, as set by scene_set_speed().
+//                      The game plays at 1 to 3 (see scene_config.h), and
+//                      starts the large display at 2.
+// display small|large  The 1.8" ST7735 or the 5" RA8875 configuration.
+// input <n> up|down    Holds the button down (up) or releases it (down) for
+//                      n ticks. Input lines are played in order and repeat
+//                      for as long as the session runs.
+//
+// ======== Peripherals ========
+//
+// The SPI bus answers every byte 16 cycles after it is written, which is the
+// time it takes to shift out at the fastest SPI clock (f_cpu / 2). Serial
+// output from the firmware is copied to stdout.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include <simavr/sim_cycle_timers.h>
+#include <simavr/avr_ioport.h>
+#include <simavr/avr_spi.h>
+#include <simavr/avr_uart.h>
+
+// =========== Constants ============
+
+#define F_CPU 16000000UL
+
+// Data address of GPIOR0, which the firmware writes stage markers to.
+#define GPIOR0_ADDR 0x3E
+
+// Top of SRAM on the ATmega2560.
+#define RAMEND 0x21FF
+
+// Cycles taken to shift a byte out of the SPI at f_cpu / 2.
+#define SPI_BYTE_CYCLES 16
+
+#define MAX_INPUTS 64
+#define NUM_STAGES 9
+
+// Stage markers, from arduino/copter/bench_stages.h.
+#define STAGE_NONE 0
+#define STAGE_TICK 0x40
+#define STAGE_DONE 0xFF
+
+// Names of the stages, indexed by their marker.
+static const char *stage_names[NUM_STAGES] = {
+    "other",
+    "redraw_frames",
+    "update_frames",
+    "redraw_blocks",
+    "update_blocks",
+    "update_copter",
+    "draw_copter",
+    "collision",
+    "idle"
+};
+
+// =========== Types ============
+
+typedef struct {
+    int ticks;          // Number of ticks the input lasts.
+    int down;           // Whether the button is held down.
+} bench_input;
+
+typedef struct {
+    unsigned long seed;
+    unsigned long ticks;
+    int speed;
+    int large;
+    bench_input inputs[MAX_INPUTS];
+    int num_inputs;
+} bench_session;
+
+typedef struct {
+    avr_t *avr;
+    const bench_session *session;
+    avr_irq_t *button;              // Button pin of the firmware.
+    avr_irq_t *spi_input;           // Input of the SPI peripheral.
+    uint8_t spi_reply_pending;      // Whether an SPI byte is being shifted.
+
+    int stage;                      // Stage the firmware is in.
+    avr_cycle_count_t stage_start;  // Cycle at which the stage started.
+    avr_cycle_count_t cycles[NUM_STAGES];   // Cycles spent in each stage.
+
+    unsigned long ticks;            // Ticks started so far.
+    avr_cycle_count_t tick_start;   // Cycle at which the current tick started.
+    avr_cycle_count_t max_tick;     // Longest tick, in cycles.
+    int input_index;                // Current input of the session.
+    int input_left;                 // Ticks left of the current input.
+    int done;
+} bench_state;
+
+// =========== Function Declarations ============
+
+// Reads a session file. Returns 0 on success.
+static int read_session(const char *path, bench_session *session);
+
+// Called when the firmware writes to GPIOR0.
+static void stage_write(avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param);
+
+// Called when the firmware starts shifting out an SPI byte.
+static void spi_output(struct avr_irq_t *irq, uint32_t value, void *param);
+
+// Answers the SPI byte that is being shifted out.
+static avr_cycle_count_t spi_reply(avr_t *avr, avr_cycle_count_t when, void *param);
+
+// Called for every byte the firmware writes to Serial.
+static void uart_output(struct avr_irq_t *irq, uint32_t value, void *param);
+
+// Prints the cycles spent in each stage.
+static void print_report(const bench_state *state, uint16_t min_sp);
+
+// =========== Function Implementations ============
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <firmware.elf> <session file>\n", argv[0]);
+        return 2;
+    }
+
+    bench_session session;
+    if (read_session(argv[2], &session) != 0) {
+        return 1;
+    }
+
+    elf_firmware_t firmware;
+    memset(&firmware, 0, sizeof(firmware));
+    if (elf_read_firmware(argv[1], &firmware) != 0) {
+        fprintf(stderr, "bench_runner: can't read %s\n", argv[1]);
+        return 1;
+    }
+    avr_t *avr = avr_make_mcu_by_name("atmega2560");
+    if (avr == NULL) {
+        fprintf(stderr, "bench_runner: simavr doesn't support the atmega2560\n");
+        return 1;
+    }
+    avr_init(avr);
+    avr->frequency = F_CPU;
+    avr_load_firmware(avr, &firmware);
+
+    bench_state state;
+    memset(&state, 0, sizeof(state));
+    state.avr = avr;
+    state.session = &session;
+    state.input_left = session.inputs[0].ticks;
+
+    // Serial output goes to stdout rather than simavr's own line buffering.
+    uint32_t flags = 0;
+    avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+    flags &= ~AVR_UART_FLAG_STDIO;
+    avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT),
+                            uart_output, NULL);
+
+    // Send the session setup line, which is queued by the UART.
+    char line[64];
+    snprintf(line, sizeof(line), "%lu %lu %d %d\n", session.seed, session.ticks, session.speed, session.large);
+    avr_irq_t *uart_input = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+    for (char *c = line; *c; c++) {
+        avr_raise_irq(uart_input, *c);
+    }
+
+    // Pin 9 of the Mega is PH6. The button pulls it low when held down.
+    state.button = avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('H'), 6);
+    avr_raise_irq(state.button, 1);
+
+    state.spi_input = avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_INPUT);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_SPI_GETIRQ(0), SPI_IRQ_OUTPUT),
+                            spi_output, &state);
+
+    avr_register_io_write(avr, GPIOR0_ADDR, stage_write, &state);
+
+    uint16_t min_sp = RAMEND;
+    int run_state = cpu_Running;
+    while (!state.done && run_state != cpu_Done && run_state != cpu_Crashed) {
+        run_state = avr_run(avr);
+        uint16_t sp = avr->data[R_SPL] | (avr->data[R_SPH] << 8);
+        if (sp < min_sp) min_sp = sp;
+    }
+    if (run_state == cpu_Crashed) {
+        fprintf(stderr, "bench_runner: the firmware crashed\n");
+        return 1;
+    }
+    print_report(&state, min_sp);
+    return 0;
+}
+
+static int read_session(const char *path, bench_session *session) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "bench_runner: can't open %s\n", path);
+        return 1;
+    }
+    memset(session, 0, sizeof(*session));
+    session->seed = 1;
+    session->ticks = 1000;
+    session->speed = 1;
+
+    char line[128];
+    int number = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        number++;
+        char key[16], value[16];
+        unsigned long n;
+        if (line[0] == '#' || sscanf(line, "%15s", key) != 1) continue;
+
+        int ok = 0;
+        if (strcmp(key, "seed") == 0) {
+            ok = sscanf(line, "%*s %lu", &session->seed) == 1;
+        } else if (strcmp(key, "ticks") == 0) {
+            ok = sscanf(line, "%*s %lu", &session->ticks) == 1;
+        } else if (strcmp(key, "speed") == 0) {
+            ok = sscanf(line, "%*s %d", &session->speed) == 1;
+        } else if (strcmp(key, "display") == 0 && sscanf(line, "%*s %15s", value) == 1) {
+            ok = strcmp(value, "small") == 0 || strcmp(value, "large") == 0;
+            session->large = strcmp(value, "large") == 0;
+        } else if (strcmp(key, "input") == 0 && session->num_inputs < MAX_INPUTS &&
+                   sscanf(line, "%*s %lu %15s", &n, value) == 2 && n > 0) {
+            ok = strcmp(value, "up") == 0 || strcmp(value, "down") == 0;
+            bench_input *input = &session->inputs[session->num_inputs++];
+            input->ticks = n;
+            input->down = strcmp(value, "up") == 0;
+        }
+        if (!ok) {
+            fprintf(stderr, "%s:%d: can't parse \"%s\"\n", path, number, strtok(line, "\n"));
+            fclose(f);
+            return 1;
+        }
+    }
+    fclose(f);
+
+    if (session->num_inputs == 0) {
+        // Without any input, the copter just falls.
+        session->inputs[0] = (bench_input){1, 0};
+        session->num_inputs = 1;
+    }
+    return 0;
+}
+
+static void stage_write(avr_t *avr, avr_io_addr_t addr, uint8_t v, void *param) {
+    bench_state *state = (bench_state *)param;
+    avr->data[addr] = v;
+    avr_cycle_count_t now = avr->cycle;
+
+    // Setting up the scene before the first tick isn't counted.
+    int counting = state->ticks > 0 && !state->done;
+
+    if (v == STAGE_TICK) {
+        if (state->ticks > 0 && now - state->tick_start > state->max_tick) {
+            state->max_tick = now - state->tick_start;
+        }
+        state->ticks++;
+        state->tick_start = now;
+
+        // Move on to the next input of the session, then set the button.
+        if (state->input_left == 0) {
+            state->input_index = (state->input_index + 1) % state->session->num_inputs;
+            state->input_left = state->session->inputs[state->input_index].ticks;
+        }
+        state->input_left--;
+        avr_raise_irq(state->button, state->session->inputs[state->input_index].down ? 0 : 1);
+        v = STAGE_NONE;
+    } else if (v == STAGE_DONE) {
+        if (state->ticks > 0 && now - state->tick_start > state->max_tick) {
+            state->max_tick = now - state->tick_start;
+        }
+        state->done = 1;
+        v = STAGE_NONE;
+    } else if (v >= NUM_STAGES) {
+        fprintf(stderr, "bench_runner: unknown stage %d\n", v);
+        v = STAGE_NONE;
+    }
+
+    if (counting) {
+        state->cycles[state->stage] += now - state->stage_start;
+    }
+    state->stage = v;
+    state->stage_start = now;
+}
+
+static void spi_output(struct avr_irq_t *irq, uint32_t value, void *param) {
+    bench_state *state = (bench_state *)param;
+    if (state->spi_reply_pending) return;
+    state->spi_reply_pending = 1;
+    avr_cycle_timer_register(state->avr, SPI_BYTE_CYCLES, spi_reply, state);
+}
+
+static avr_cycle_count_t spi_reply(avr_t *avr, avr_cycle_count_t when, void *param) {
+    bench_state *state = (bench_state *)param;
+    state->spi_reply_pending = 0;
+    avr_raise_irq(state->spi_input, 0xFF);
+    return 0;
+}
+
+static void uart_output(struct avr_irq_t *irq, uint32_t value, void *param) {
+    putchar(value);
+    if (value == '\n') fflush(stdout);
+}
+
+static void print_report(const bench_state *state, uint16_t min_sp) {
+    unsigned long ticks = state->ticks ? state->ticks : 1;
+    avr_cycle_count_t total = 0;
+    for (int i = 0; i < NUM_STAGES; i++) {
+        total += state->cycles[i];
+    }
+
+    printf("\n%lu ticks, %s display, speed %d, seed %lu\n", state->ticks,
+           state->session->large ? "large" : "small", state->session->speed, state->session->seed);
+    printf("%-14s %14s %12s %10s %6s\n", "stage", "cycles", "per tick", "us/tick", "%");
+    for (int i = 1; i <= NUM_STAGES; i++) {
+        int stage = i % NUM_STAGES;    // "other" goes last.
+        avr_cycle_count_t cycles = state->cycles[stage];
+        printf("%-14s %14llu %12llu %10.1f %6.1f\n", stage_names[stage],
+               (unsigned long long)cycles,
+               (unsigned long long)(cycles / ticks),
+               cycles / (double)ticks * 1e6 / F_CPU,
+               total ? cycles * 100.0 / total : 0.0);
+    }
+    printf("longest tick: %llu cycles (%.1f us)\n", (unsigned long long)state->max_tick,
+           state->max_tick * 1e6 / F_CPU);
+    printf("stack peak: %u bytes (lowest SP 0x%04X)\n", RAMEND - min_sp, min_sp);
+}
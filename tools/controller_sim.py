@@ -0,0 +1,517 @@
+#!/usr/bin/env python3
+# ArduinoCopter
+# controller_sim.py
+#
+# Created October 19, 2026
+#
+# Stands in for the Bluetooth bridge and the controller on Linux, so that the
+# game's receive path (arduino/copter/bt_receiver.h) can be driven without the
+# iOS app, the second Arduino and the BLE shield. The two supported targets
+# are a game on a real Mega, through a USB serial adapter wired to Serial3 in
+# place of the bridge, and a game running under simavr, through the pty that
+# its uart_pty part creates for Serial3. Either one is passed with --device.
+# Without --device, a pty is created for some other program to open; there is
+# no host build of the game in this tree that does so.
+#
+# Like the bridge, it acknowledges the link hellos of the game (switching the
+# baud rate of a real serial device), and like the controller it answers pings
+# and sends button presses and play/pause toggles. Presses come from a script,
+# from a load generator running at a fixed rate, or both, and can be mixed with
+# malformed bytes. Everything that the game sends is printed with the time it
+# arrived, followed by a summary once the run is over.
+#
+# Usage: controller_sim.py [--device <path> | --link <path>] [--script <file>]
+#                          [--rate <presses/s> | --rate max] [--duration <s>]
+#                          [--malformed <fraction>] [--legacy] [--no-pong]
+#                          [--wait] [--seed <n>] [--csv]
+#
+#   --device    Serial device to use: the USB serial adapter, or the pty made by
+#               simavr's uart_pty. Without it, a pty is created and the path of
+#               the other end is printed.
+#   --link      Also makes a symlink to the other end of the pty at this path.
+#   --script    Button timeline to play (see below).
+#   --rate      Presses per second sent by the load generator, alternating down
+#               and up, or 'max' to keep the link full.
+#   --duration  Seconds that the load generator runs for (default 10).
+#   --malformed Fraction of the messages that are preceded by malformed bytes.
+#   --legacy    Sends unsequenced button presses (0x01) instead of sequenced
+#               ones (0x0B).
+#   --no-pong   Leaves pings unanswered, which the game counts as lost.
+#   --wait      Starts the script and the load generator once the game has set
+#               up the link, rather than right away. The game drops anything
+#               received before its link hellos, so this is needed when the
+#               game starts after this tool does.
+#   --linger    Seconds to keep listening once there is nothing left to send
+#               (default 1). Without a script or load, it runs until Ctrl-C.
+#   --seed      Seed for the malformed bytes.
+#   --csv       Prints the received messages as time,message,value.
+#
+# ======== Script Format ========
+#
+# One event per line, starting with the time in milliseconds from the start of
+# the run (or from the link setup, with --wait), or '+' and the time from the
+# previous event. '#' starts a comment.
+#
+#   <ms> down                   Button press down.
+#   <ms> up                     Button press up.
+#   <ms> press <hold ms>        Button press down, then up after the hold time.
+#   <ms> toggle                 Toggles play/pause.
+#   <ms> burst <count> <ms>     Count presses, alternating down and up, spaced
+#                               by the given time (0 sends them all at once).
+#   <ms> garbage <count>        Count malformed bytes.
+#   <ms> bytes <hex> ...        Raw bytes, e.g. 'bytes 0a 01' for a cut off pong.
+#   <ms> skip <count>           Skips sequence numbers, as if presses were lost.
+#
+# For example, starting a round and holding the button for half a second every
+# second:
+#
+#   0 press 100
+#   +1000 press 500
+#   +1000 press 500
+
+import argparse
+import collections
+import errno
+import fcntl
+import os
+import random
+import select
+import struct
+import sys
+import termios
+import time
+import tty
+
+BAUD_RATES = [9600, 19200, 38400, 57600]
+TERMIOS_RATES = [termios.B9600, termios.B19200, termios.B38400, termios.B57600]
+
+# Commands received from the game, and the number of bytes that follow each.
+GAME_RESET = 0x03
+GAME_SCORE = 0x04
+GAME_HIGH_SCORE = 0x05
+GAME_HELLO = 0x06
+GAME_PING = 0x09
+PAYLOAD_LENGTHS = {GAME_RESET: 0, GAME_SCORE: 4, GAME_HIGH_SCORE: 4, GAME_HELLO: 1, GAME_PING: 5}
+
+# Commands sent to the game.
+BUTTON = 0x01
+TOGGLE = 0x02
+LINK_ACK = 0x07
+PONG = 0x0A
+SEQUENCED_BUTTON = 0x0B
+
+# Time that the bridge waits for the game to confirm a new baud rate, in seconds.
+CONFIRM_TIMEOUT = 0.1
+
+# Bytes kept queued while the load generator runs at 'max'.
+MAX_RATE_QUEUE = 64
+
+
+class ScriptError(Exception):
+    pass
+
+
+class Controller(object):
+    """The bridge and controller, as seen by the game."""
+
+    def __init__(self, fd, is_tty, args):
+        self.fd = fd
+        self.is_tty = is_tty
+        self.args = args
+        self.random = random.Random(args.seed)
+        self.start = time.monotonic()
+        self.received = bytearray()
+        self.messages = collections.deque()
+        self.sending = b''
+        self.queued = 0
+        self.button_sequence = 0
+        self.baud_index = 0
+        self.confirm_deadline = None
+        self.linked = False
+        self.sent = collections.Counter()
+        self.sent_bytes = 0
+        self.got = collections.Counter()
+        self.stray_bytes = 0
+        self.score_times = []
+
+    def now(self):
+        return time.monotonic() - self.start
+
+    # ---- Sending ----
+
+    def button(self, down):
+        state = 1 if down else 0
+        if self.args.legacy:
+            self.send(bytes([BUTTON, state]), 'button')
+        else:
+            self.send(bytes([SEQUENCED_BUTTON, self.button_sequence, state]), 'button')
+            self.button_sequence = (self.button_sequence + 1) & 0xFF
+
+    def toggle(self):
+        self.send(bytes([TOGGLE]), 'toggle')
+
+    def skip(self, count):
+        self.button_sequence = (self.button_sequence + count) & 0xFF
+
+    def garbage(self, count):
+        data = bytearray()
+        while len(data) < count:
+            data += self.malformed_bytes()
+        self.send(bytes(data[:count]), 'malformed')
+
+    def malformed_bytes(self):
+        """Returns a short run of bytes that the game should drop or resync from."""
+        kind = self.random.randrange(4)
+        if kind == 0:
+            # A header that the game doesn't know.
+            return bytes([self.random.choice([0x00, 0x03, 0x04, 0x08] + list(range(0x0C, 0x100)))])
+        elif kind == 1:
+            # A command that is cut off, which swallows the start of the next one.
+            command = self.random.choice([[BUTTON, 1], [SEQUENCED_BUTTON, 0, 1], [PONG] + [0] * 9])
+            return bytes(command[:self.random.randrange(1, len(command))])
+        elif kind == 2:
+            # A button press with a state other than up or down.
+            return bytes([BUTTON, self.random.randrange(2, 0x100)])
+        else:
+            # A link acknowledgement that the game didn't ask for.
+            return bytes([LINK_ACK, self.random.randrange(len(BAUD_RATES))])
+
+    def send(self, data, kind):
+        if self.args.malformed > 0 and kind != 'malformed' and self.random.random() < self.args.malformed:
+            self.queue(self.malformed_bytes(), 'malformed')
+        self.queue(data, kind)
+
+    def queue(self, data, kind, first=False):
+        """Queues a message to be written, after the others or ahead of them."""
+        if first:
+            self.messages.appendleft((data, kind))
+        else:
+            self.messages.append((data, kind))
+        self.queued += len(data)
+
+    def queued_bytes(self):
+        return self.queued
+
+    def write(self):
+        """Writes as much of the queued messages as the device takes."""
+        while True:
+            if not self.sending:
+                if not self.messages:
+                    return
+                self.sending, kind = self.messages.popleft()
+                self.sent[kind] += 1
+            try:
+                n = os.write(self.fd, self.sending)
+            except OSError as e:
+                if e.errno in (errno.EAGAIN, errno.EIO):
+                    return
+                raise
+            self.sent_bytes += n
+            self.queued -= n
+            self.sending = self.sending[n:]
+            if self.sending:
+                return
+
+    # ---- Receiving ----
+
+    def read(self):
+        try:
+            data = os.read(self.fd, 4096)
+        except OSError as e:
+            # The other end of a pty hasn't been opened yet, or was closed.
+            if e.errno in (errno.EAGAIN, errno.EIO):
+                return
+            raise
+        self.received += data
+        self.parse()
+
+    def parse(self):
+        while self.received:
+            header = self.received[0]
+            length = PAYLOAD_LENGTHS.get(header)
+            if length is None:
+                self.stray_bytes += 1
+                del self.received[0]
+                continue
+            if len(self.received) < 1 + length:
+                return
+            payload = bytes(self.received[1:1 + length])
+            del self.received[:1 + length]
+            self.handle(header, payload)
+
+    def handle(self, header, payload):
+        t = self.now()
+        if header == GAME_RESET:
+            self.got['reset'] += 1
+            self.record(t, 'reset', '')
+        elif header == GAME_SCORE:
+            score, = struct.unpack('<I', payload)
+            self.got['score'] += 1
+            self.score_times.append(t)
+            self.record(t, 'score', score)
+        elif header == GAME_HIGH_SCORE:
+            score, = struct.unpack('<I', payload)
+            self.got['high_score'] += 1
+            self.record(t, 'high_score', score)
+        elif header == GAME_HELLO:
+            self.got['hello'] += 1
+            self.record(t, 'hello', BAUD_RATES[payload[0]] if payload[0] < len(BAUD_RATES) else payload[0])
+            self.hello(payload[0])
+        elif header == GAME_PING:
+            sequence, game_time = struct.unpack('<BI', payload)
+            self.got['ping'] += 1
+            if not self.args.no_pong:
+                # Pongs go out ahead of queued presses, like a controller that
+                # answers as soon as the ping arrives.
+                controller_time = int(t * 1000) & 0xFFFFFFFF
+                self.queue(struct.pack('<BBII', PONG, sequence, game_time, controller_time), 'pong', first=True)
+
+    def record(self, t, message, value):
+        if self.args.csv:
+            print('%.3f,%s,%s' % (t, message, value))
+        else:
+            print('%10.3f  %-10s %s' % (t, message, value))
+        sys.stdout.flush()
+
+    def hello(self, index):
+        if index >= len(BAUD_RATES):
+            return
+
+        # Acknowledge at the current rate before switching, as the bridge does.
+        self.queue(bytes([LINK_ACK, index]), 'link', first=True)
+        if index == self.baud_index:
+            self.confirm_deadline = None
+            self.linked = True
+        else:
+            self.flush()
+            self.set_baud(index)
+            self.confirm_deadline = time.monotonic() + CONFIRM_TIMEOUT
+
+    def check_confirm(self):
+        if self.confirm_deadline is not None and time.monotonic() >= self.confirm_deadline:
+            self.set_baud(0)
+            self.confirm_deadline = None
+
+    def flush(self):
+        while self.sending or self.messages:
+            self.write()
+            if self.sending or self.messages:
+                select.select([], [self.fd], [], 0.01)
+        if self.is_tty:
+            termios.tcdrain(self.fd)
+
+    def set_baud(self, index):
+        self.baud_index = index
+        if not self.is_tty:
+            return
+        attrs = termios.tcgetattr(self.fd)
+        attrs[4] = attrs[5] = TERMIOS_RATES[index]
+        termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+
+    # ---- Summary ----
+
+    def summary(self):
+        elapsed = max(self.now(), 1e-3)
+        out = sys.stderr
+        out.write('\n%.3f s, %d bytes sent (%d bytes/s)\n' % (elapsed, self.sent_bytes, self.sent_bytes / elapsed))
+        out.write('sent: %s\n' % format_counts(self.sent))
+        out.write('received: %s' % format_counts(self.got))
+        out.write(', %d stray bytes\n' % self.stray_bytes if self.stray_bytes else '\n')
+        out.write('link: %d baud\n' % BAUD_RATES[self.baud_index])
+
+        # The game sends the score every few ticks, so the gaps between scores
+        # show how long its ticks take while the input is coming in.
+        gaps = [b - a for a, b in zip(self.score_times, self.score_times[1:])]
+        if gaps:
+            out.write('score gaps: min %.1f ms, avg %.1f ms, max %.1f ms\n' % (
+                min(gaps) * 1000, sum(gaps) / len(gaps) * 1000, max(gaps) * 1000))
+
+
+def format_counts(counts):
+    if not counts:
+        return 'nothing'
+    return ', '.join('%d %s' % (counts[k], k) for k in sorted(counts))
+
+
+def parse_script(path):
+    """Returns the events of a script as a list of (seconds, action, arguments)."""
+    events = []
+    last = 0
+    with open(path) as f:
+        for number, line in enumerate(f, 1):
+            words = line.split('#', 1)[0].split()
+            if not words:
+                continue
+            try:
+                if words[0].startswith('+'):
+                    t = last + int(words[0][1:])
+                else:
+                    t = int(words[0])
+                action, rest = words[1], words[2:]
+                if action in ('down', 'up', 'toggle'):
+                    arguments = []
+                elif action in ('press', 'garbage', 'skip'):
+                    arguments = [int(rest[0])]
+                elif action == 'burst':
+                    arguments = [int(rest[0]), int(rest[1])]
+                elif action == 'bytes':
+                    arguments = [bytes(int(b, 16) for b in rest)]
+                else:
+                    raise ScriptError('%s:%d: unknown event %r' % (path, number, action))
+            except (IndexError, ValueError):
+                raise ScriptError('%s:%d: bad event %r' % (path, number, line.strip()))
+            events.append((t / 1000.0, action, arguments))
+            last = t
+
+    # Presses and bursts are made of events of their own.
+    expanded = []
+    for t, action, arguments in events:
+        if action == 'press':
+            expanded.append((t, 'down', []))
+            expanded.append((t + arguments[0] / 1000.0, 'up', []))
+        elif action == 'burst':
+            count, spacing = arguments
+            for i in range(count):
+                expanded.append((t + i * spacing / 1000.0, 'down' if i % 2 == 0 else 'up', []))
+        else:
+            expanded.append((t, action, arguments))
+    expanded.sort(key=lambda e: e[0])
+    return expanded
+
+
+def run_event(controller, action, arguments):
+    if action == 'down':
+        controller.button(True)
+    elif action == 'up':
+        controller.button(False)
+    elif action == 'toggle':
+        controller.toggle()
+    elif action == 'garbage':
+        controller.garbage(arguments[0])
+    elif action == 'bytes':
+        controller.send(arguments[0], 'raw')
+    elif action == 'skip':
+        controller.skip(arguments[0])
+
+
+def open_link(args):
+    """Returns (fd, is_tty) for the device, or for a new pty."""
+    if args.device:
+        fd = os.open(args.device, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        is_tty = os.isatty(fd)
+        if is_tty:
+            tty.setraw(fd)
+            attrs = termios.tcgetattr(fd)
+            attrs[4] = attrs[5] = TERMIOS_RATES[0]
+            termios.tcsetattr(fd, termios.TCSANOW, attrs)
+        return fd, is_tty
+
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    name = os.ttyname(slave)
+    fcntl.fcntl(master, fcntl.F_SETFL, fcntl.fcntl(master, fcntl.F_GETFL) | os.O_NONBLOCK)
+    if args.link:
+        if os.path.islink(args.link):
+            os.unlink(args.link)
+        os.symlink(name, args.link)
+    sys.stderr.write('controller on %s\n' % (args.link or name))
+
+    # Keeping the other end open stops reads from failing before the game
+    # opens it. The baud rate of a pty means nothing, so it isn't switched.
+    return master, False
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Simulates the controller of ArduinoCopter.')
+    link = parser.add_mutually_exclusive_group()
+    link.add_argument('--device', help='serial device connected to the game')
+    link.add_argument('--link', help='symlink to make to the pty')
+    parser.add_argument('--script', help='button timeline to play')
+    parser.add_argument('--rate', help="presses per second to generate, or 'max'")
+    parser.add_argument('--duration', type=float, default=10, help='seconds to generate presses for')
+    parser.add_argument('--malformed', type=float, default=0, help='fraction of messages with malformed bytes')
+    parser.add_argument('--legacy', action='store_true', help='send unsequenced button presses')
+    parser.add_argument('--no-pong', action='store_true', help='leave pings unanswered')
+    parser.add_argument('--wait', action='store_true', help='start once the game has set up the link')
+    parser.add_argument('--linger', type=float, default=1, help='seconds to listen once done')
+    parser.add_argument('--seed', type=int, default=0, help='seed for the malformed bytes')
+    parser.add_argument('--csv', action='store_true', help='print messages as CSV')
+    args = parser.parse_args(argv[1:])
+
+    try:
+        events = parse_script(args.script) if args.script else []
+        rate = None
+        if args.rate == 'max':
+            rate = float('inf')
+        elif args.rate is not None:
+            rate = float(args.rate)
+            if rate <= 0:
+                raise ScriptError('--rate must be positive')
+        fd, is_tty = open_link(args)
+    except (IOError, OSError, ScriptError) as e:
+        sys.stderr.write('%s: %s\n' % (argv[0], e))
+        return 1
+
+    controller = Controller(fd, is_tty, args)
+    if args.csv:
+        print('time,message,value')
+    events = collections.deque(events)
+    finite = bool(events) or rate is not None
+    origin = None
+    generated = 0
+    done_at = None
+    try:
+        while True:
+            if origin is None and (controller.linked or not args.wait):
+                origin = controller.now()
+            t = controller.now() - origin if origin is not None else None
+
+            if t is not None:
+                while events and events[0][0] <= t:
+                    _, action, arguments = events.popleft()
+                    run_event(controller, action, arguments)
+
+            # The load generator keeps up with its rate, however late the loop is.
+            generating = rate is not None and (t is None or t < args.duration)
+            if generating and t is not None:
+                if rate == float('inf'):
+                    while controller.queued_bytes() < MAX_RATE_QUEUE:
+                        controller.button(generated % 2 == 0)
+                        generated += 1
+                else:
+                    while generated < int(t * rate) + 1:
+                        controller.button(generated % 2 == 0)
+                        generated += 1
+
+            controller.check_confirm()
+            controller.write()
+
+            # Stop once everything is sent and the game has had time to answer.
+            busy = events or generating or controller.queued_bytes() > 0
+            if busy or not finite:
+                done_at = None
+            elif done_at is None:
+                done_at = t
+            elif t - done_at >= args.linger:
+                break
+
+            timeout = 0.05
+            if t is not None and events:
+                timeout = min(timeout, max(events[0][0] - t, 0))
+            if t is not None and generating and rate != float('inf'):
+                timeout = min(timeout, max(generated / rate - t, 0))
+            writers = [fd] if controller.queued_bytes() > 0 else []
+            readable, _, _ = select.select([fd], writers, [], timeout)
+            if readable:
+                controller.read()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        controller.summary()
+        if args.link and os.path.islink(args.link):
+            os.unlink(args.link)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
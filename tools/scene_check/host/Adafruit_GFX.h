@@ -0,0 +1,31 @@
+// ArduinoCopter
+// Adafruit_GFX.h
+//
+// Created October 19, 2026
+//
+// The drawing calls that the game core makes, for building it on the host.
+// Nothing is drawn; the scene check only looks at the scene's state.
+
+#ifndef __host_adafruit_gfx_h__
+#define __host_adafruit_gfx_h__
+#include <Arduino.h>
+
+class Adafruit_GFX {
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+    virtual ~Adafruit_GFX() {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) {}
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {}
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {}
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {}
+    virtual void fillScreen(uint16_t color) {}
+
+    int16_t width() { return _width; }
+    int16_t height() { return _height; }
+
+protected:
+    int16_t _width, _height;
+};
+
+#endif
@@ -0,0 +1,27 @@
+// ArduinoCopter
+// Arduino.h
+//
+// Created October 19, 2026
+//
+// The parts of the Arduino core that the game core uses, for building it on the
+// host. Flash data is read like any other memory.
+
+#ifndef __host_arduino_h__
+#define __host_arduino_h__
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(x, low, high) ((x) < (low) ? (low) : ((x) > (high) ? (high) : (x)))
+
+#endif
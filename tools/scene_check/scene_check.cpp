@@ -0,0 +1,376 @@
+// ArduinoCopter
+// scene_check.cpp
+//
+// Created October 19, 2026
+//
+// Builds the game core on the host and checks two things about the terrain and
+// blocks that it generates, which the game relies on but can't check itself:
+//
+// Dead ends: every tick, the set of states that the helicopter could be in
+// (its y, boost and gravity, as scene_update_copter() moves them) is searched
+// independently of the verifier, following both directions of the button. A
+// dead end is a tick after which no state is left that doesn't collide, which
+// means that blocks were placed that can't be flown past. The search then
+// starts over from every clear y. The game's layouts must have none at any
+// speed; the tight layout, which is much harder than either, must have none at
+// one column per tick and is only reported at the faster speeds.
+//
+// Replay: a round started from the same random state and played with the same
+// input must place the same blocks and fly the same track, however many times
+// scene_idle() is called between ticks and whatever the level of detail. This
+// is what lets sd_log_reader.py replay a round from the log.
+//
+// Usage: scene_check
+//
+// Exits with 1 if either check fails.
+
+#include <stdio.h>
+#include "arena.h"
+#include "helicopter.h"
+#include "rng.h"
+#include "scene.h"
+#include "scene_config.h"
+
+// =========== Constants ============
+
+// A layout with a narrow, steep tunnel and blocks close together, which leaves
+// the verifier very little room.
+static const int tight_scene_spacing = 52;
+static const int tight_scene_max_delta = 2;
+static const int tight_scene_block_distance = 30;
+static const int tight_scene_block_height = 22;
+
+// Rounds and ticks per round searched for dead ends. Rounds without a fixed
+// speed start at 1 to 3 columns per tick and speed up as the game does.
+static const int search_rounds = 30;
+static const int search_ticks = 4000;
+static const int search_speed_up_ticks = 500;
+
+// Rows above and below the display that the search follows the helicopter
+// into, since the terrain ends at the edges.
+static const int search_margin = 16;
+
+// Rounds and ticks per round of each replay, and the number of replays compared
+// against the first for each layout.
+static const int replay_rounds = 4;
+static const int replay_ticks = 6000;
+static const int replay_runs = 50;
+
+// Ticks between speed changes during a replay, so that steps change while
+// frames of every speed are still in the look-ahead.
+static const int replay_speed_ticks = 97;
+
+// Most times that scene_idle() is called between two ticks of a replay.
+static const int replay_max_idles = 40;
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define TIGHT_SCENE_MEMORY_BYTES SCENE_MEMORY_BYTES(small_lcd_width, small_lcd_height, \
+    tight_scene_block_distance, scene_block_width)
+#define MAX_SEARCH_ROWS (large_lcd_height + 2 * search_margin)
+#define SEARCH_STATES (MAX_SEARCH_ROWS * (HELICOPTER_MAX_BOOST + 1) * (HELICOPTER_MAX_GRAVITY + 1))
+
+// =========== Types ============
+
+typedef enum {
+    layout_small,
+    layout_large,
+    layout_tight,
+    num_layouts
+} scene_layout;
+
+typedef struct {
+    uint32_t blocks;    // Hash of the blocks placed, by the column they scrolled in at.
+    uint32_t track;     // Hash of the helicopter's y and collisions on each tick.
+} replay_result;
+
+// The display that the scene draws into. Nothing is drawn.
+class HostDisplay : public Adafruit_GFX {
+public:
+    HostDisplay() : Adafruit_GFX(large_lcd_width, large_lcd_height) {}
+};
+
+// =========== Function Declarations ============
+
+// Sets up the arena and creates a scene with a layout.
+static scene *check_scene_new(scene_layout layout, rng *random);
+
+// Searches rounds of a layout for dead ends.
+//
+// @param layout    The layout.
+// @param speed     Columns scrolled per tick, or 0 to vary it as the game does.
+//
+// @return The number of dead ends found.
+static long search_dead_ends(scene_layout layout, int speed);
+
+// Returns whether the helicopter collides when drawn at a position, checking the
+// terrain and blocks the same way that scene_detect_collision() does.
+static boolean search_collides(scene *s, int x, int y);
+
+// Plays rounds of a layout with the same random state and input.
+//
+// @param layout    The layout.
+// @param idle_seed Seed for the number of idle calls and the level of detail
+//                  on each tick, or 0 for one idle call at full detail.
+static replay_result replay(scene_layout layout, unsigned int idle_seed);
+
+// Adds a value to an FNV-1a hash.
+static uint32_t hash_add(uint32_t hash, long value);
+
+// =========== Global Variables ============
+
+static const char *layout_names[num_layouts] = {"small", "large", "tight"};
+
+static ARENA_BUFFER(check_memory, MAX(MAX(SMALL_SCENE_MEMORY_BYTES, LARGE_SCENE_MEMORY_BYTES),
+    TIGHT_SCENE_MEMORY_BYTES));
+
+static HostDisplay display;
+
+// Helicopter states reachable on the current and next tick, indexed by row,
+// boost and gravity.
+static uint8_t search_states[SEARCH_STATES];
+static uint8_t search_next[SEARCH_STATES];
+
+// Whether each row is clear on the current tick: 1 or 0, or -1 if it hasn't
+// been checked yet.
+static int8_t search_clear[MAX_SEARCH_ROWS];
+
+// =========== Function Implementations ============
+
+int main() {
+    int failed = 0;
+
+    for (int layout = 0; layout < num_layouts; layout++) {
+        for (int speed = 0; speed <= max_scroll_step; speed++) {
+            long dead_ends = search_dead_ends((scene_layout)layout, speed);
+            boolean required = layout != layout_tight || speed == small_base_scroll_step;
+            if (speed == 0) {
+                printf("dead ends, %s layout, varied speed: %ld", layout_names[layout], dead_ends);
+            } else {
+                printf("dead ends, %s layout, speed %d: %ld", layout_names[layout], speed, dead_ends);
+            }
+            if (!required) {
+                printf(" (reported only)\n");
+            } else if (dead_ends != 0) {
+                printf(" FAILED\n");
+                failed = 1;
+            } else {
+                printf("\n");
+            }
+        }
+    }
+
+    for (int layout = 0; layout < num_layouts; layout++) {
+        replay_result expected = replay((scene_layout)layout, 0);
+        int differing = 0;
+        for (int run = 1; run <= replay_runs; run++) {
+            replay_result result = replay((scene_layout)layout, run);
+            if (result.blocks != expected.blocks || result.track != expected.track) {
+                differing++;
+            }
+        }
+        printf("replays, %s layout: %d of %d differ%s\n", layout_names[layout], differing, replay_runs,
+            differing != 0 ? " FAILED" : "");
+        if (differing != 0) {
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
+
+static scene *check_scene_new(scene_layout layout, rng *random) {
+    scene_colors colors = {0, 1, 2, 3};
+    arena_init(check_memory, sizeof(check_memory));
+    switch (layout) {
+        case layout_large:
+            return scene_new(&display, (g_size){large_lcd_width, large_lcd_height}, large_scene_spacing,
+                scene_max_delta, large_scene_block_distance, (g_size){scene_block_width, scene_block_height},
+                colors, random);
+        case layout_tight:
+            return scene_new(&display, (g_size){small_lcd_width, small_lcd_height}, tight_scene_spacing,
+                tight_scene_max_delta, tight_scene_block_distance,
+                (g_size){scene_block_width, tight_scene_block_height}, colors, random);
+        default:
+            return scene_new(&display, (g_size){small_lcd_width, small_lcd_height}, small_scene_spacing,
+                scene_max_delta, small_scene_block_distance, (g_size){scene_block_width, scene_block_height},
+                colors, random);
+    }
+}
+
+static long search_dead_ends(scene_layout layout, int speed) {
+    rng random;
+    rng_seed(&random, 99);
+    scene *s = check_scene_new(layout, &random);
+    int height = layout == layout_large ? large_lcd_height : small_lcd_height;
+    int rows = height + 2 * search_margin;
+    long dead_ends = 0;
+
+    for (int round = 0; round < search_rounds; round++) {
+        int step = speed != 0 ? speed : 1 + round % max_scroll_step;
+        scene_reset(s);
+        scene_set_speed(s, step);
+        memset(search_states, 0, sizeof(search_states));
+        search_states[(s->copter_pos.y + search_margin) * (HELICOPTER_MAX_BOOST + 1) *
+            (HELICOPTER_MAX_GRAVITY + 1)] = 1;
+
+        for (int t = 0; t < search_ticks; t++) {
+            if (speed == 0 && t % search_speed_up_ticks == search_speed_up_ticks - 1 &&
+                step < max_scroll_step) {
+                scene_set_speed(s, ++step);
+            }
+            scene_update(s, (t / 5) % 2 ? copter_up : copter_down);
+            scene_idle(s);
+
+            // The helicopter moves scroll_step columns past the terrain on each
+            // tick, and collides with anything in between.
+            memset(search_next, 0, sizeof(search_next));
+            memset(search_clear, -1, sizeof(search_clear));
+            boolean any = false;
+            for (int i = 0; i < rows * (HELICOPTER_MAX_BOOST + 1) * (HELICOPTER_MAX_GRAVITY + 1); i++) {
+                if (!search_states[i]) {
+                    continue;
+                }
+                int gravity = i % (HELICOPTER_MAX_GRAVITY + 1);
+                int boost = i / (HELICOPTER_MAX_GRAVITY + 1) % (HELICOPTER_MAX_BOOST + 1);
+                int y = i / ((HELICOPTER_MAX_GRAVITY + 1) * (HELICOPTER_MAX_BOOST + 1)) - search_margin;
+                for (int up = 0; up < 2; up++) {
+                    int new_boost = up ? min(boost + 1, HELICOPTER_MAX_BOOST) : max(boost - 1, 0);
+                    int new_gravity = min(gravity + 1, HELICOPTER_MAX_GRAVITY);
+                    int row = y + helicopter_dy(new_gravity, new_boost) + search_margin;
+                    if (row < 0 || row >= rows) {
+                        continue;
+                    }
+                    if (search_clear[row] < 0) {
+                        search_clear[row] = 1;
+                        for (int lag = 0; lag < s->scroll_step; lag++) {
+                            if (search_collides(s, s->copter_pos.x - lag, row - search_margin)) {
+                                search_clear[row] = 0;
+                                break;
+                            }
+                        }
+                    }
+                    if (search_clear[row]) {
+                        search_next[(row * (HELICOPTER_MAX_BOOST + 1) + new_boost) *
+                            (HELICOPTER_MAX_GRAVITY + 1) + new_gravity] = 1;
+                        any = true;
+                    }
+                }
+            }
+
+            if (!any) {
+                // Start over from every row that is clear, falling at full gravity.
+                dead_ends++;
+                for (int row = 0; row < rows; row++) {
+                    boolean clear = true;
+                    for (int lag = 0; lag < s->scroll_step && clear; lag++) {
+                        clear = !search_collides(s, s->copter_pos.x - lag, row - search_margin);
+                    }
+                    for (int boost = 0; clear && boost <= HELICOPTER_MAX_BOOST; boost++) {
+                        search_next[(row * (HELICOPTER_MAX_BOOST + 1) + boost) *
+                            (HELICOPTER_MAX_GRAVITY + 1) + HELICOPTER_MAX_GRAVITY] = 1;
+                    }
+                }
+            }
+            memcpy(search_states, search_next, sizeof(search_states));
+        }
+    }
+
+    scene_free(s);
+    return dead_ends;
+}
+
+static boolean search_collides(scene *s, int x, int y) {
+    for (int column = 0; column < helicopter_size.width; column++) {
+        uint8_t mask = helicopter_mask(column);
+        if (mask == 0) {
+            continue;
+        }
+        int cx = x + column;
+        uint8_t solid = gen_column_mask(s->gen, cx, y);
+        for (size_t i = 0; i < s->num_blocks; i++) {
+            g_rect r = s->block_rects[i];
+            if (cx < r.origin.x || cx >= r.origin.x + r.size.width) {
+                continue;
+            }
+            int top = max(r.origin.y - y, 0);
+            int bottom = min(r.origin.y + r.size.height - y, 8);
+            if (bottom > top) {
+                solid |= ((1 << bottom) - 1) & ~((1 << top) - 1);
+            }
+        }
+        if (solid & mask) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static replay_result replay(scene_layout layout, unsigned int idle_seed) {
+    rng random;
+    rng_seed(&random, 1234);
+    scene *s = check_scene_new(layout, &random);
+    int height = layout == layout_large ? large_lcd_height : small_lcd_height;
+    replay_result result = {2166136261u, 2166136261u};
+    srand(idle_seed);
+
+    for (int round = 0; round < replay_rounds; round++) {
+        // Each round starts from its own random state, as a round in the log does.
+        rng_seed(&random, 1234 + round);
+        scene_reset(s);
+        int step = 1;
+        scene_set_speed(s, step);
+        long scrolled = 0;
+        long last_block = -1;
+
+        for (int t = 0; t < replay_ticks; t++) {
+            // The last update of a round is at full detail, which draws whatever
+            // the update before it deferred, so that every replay ends on the
+            // same column.
+            scene_detail detail = scene_detail_full;
+            if (idle_seed != 0 && t < replay_ticks - 1) {
+                detail = (scene_detail)(rand() % 4);
+            }
+            scene_set_detail(s, detail);
+            copter_direction dir = s->copter_pos.y > height / 2 ? copter_up : copter_down;
+            boolean collided = scene_update(s, dir);
+            scrolled += s->scroll_step;
+
+            // Blocks are drawn late at lower detail, so they are told apart by
+            // the column that they scrolled in at rather than by where they are
+            // on screen.
+            for (size_t i = 0; i < s->num_blocks; i++) {
+                long column = scrolled - s->deferred_scroll + s->block_rects[i].origin.x;
+                if (column > last_block) {
+                    result.blocks = hash_add(hash_add(result.blocks, column), s->block_rects[i].origin.y);
+                    last_block = column;
+                }
+            }
+            result.track = hash_add(result.track, s->copter_pos.y * 2 + collided);
+
+            if (t % replay_speed_ticks == replay_speed_ticks - 1) {
+                step = step % max_scroll_step + 1;
+                scene_set_speed(s, step);
+            }
+
+            // Some stretches get no idle time at all, as when the game is busy
+            // drawing the HUD or writing the log.
+            int idles = 1;
+            if (idle_seed != 0) {
+                idles = (t / 50 + idle_seed) % 3 == 0 ? 0 : rand() % replay_max_idles;
+            }
+            for (int i = 0; i < idles; i++) {
+                scene_idle(s);
+            }
+        }
+    }
+
+    scene_free(s);
+    return result;
+}
+
+static uint32_t hash_add(uint32_t hash, long value) {
+    for (int i = 0; i < 4; i++) {
+        hash = (hash ^ (uint8_t)(value >> (8 * i))) * 16777619u;
+    }
+    return hash;
+}
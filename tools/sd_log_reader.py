@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+# ArduinoCopter
+# sd_log_reader.py
+#
+# Created October 19, 2026
+#
+# Reads the telemetry and input log that the game writes to the SD card when
+# built with SD_LOG (see arduino/copter/sd_log.h for the format). The input can
+# be COPTER.LOG copied off the card, an image of the whole card, or the card's
+# block device itself (e.g. /dev/sdb, which usually needs root). Blocks are
+# found by their magic number, so the file system is never looked at.
+#
+# Usage: sd_log_reader.py [--session <id>] [--csv | --replay] <log or device>
+#
+#   (default)   Prints every round of every session with a summary of its ticks.
+#   --csv       Prints one line per tick, for loading into a spreadsheet.
+#   --replay    Prints what is needed to replay each round exactly (see
+#               sd_log.h): the rng state, display and starting scroll step, then
+#               the button input, one character per tick ('1' for down, '0' for
+#               up), and the scroll step of each tick, one digit per tick.
+#   --session   Only reads the session with this ID.
+
+import argparse
+import struct
+import sys
+
+BLOCK_SIZE = 512
+HEADER = struct.Struct('<4sBBHII')
+MAGIC = b'CPLG'
+VERSION = 1
+
+RECORD_ROUND_START = 0x01
+RECORD_TICK = 0x02
+RECORD_ROUND_END = 0x03
+
+ROUND_START = struct.Struct('<IBB')
+TICK = struct.Struct('<BBHHI')
+ROUND_END = struct.Struct('<IH')
+
+TICK_BUTTON = 0x01
+TICK_COLLISION = 0x02
+
+DISPLAYS = {0: '1.8"', 1: '5"'}
+
+
+class LogError(Exception):
+    pass
+
+
+class Round(object):
+    def __init__(self, rng_state, display, scroll_step):
+        self.rng_state = rng_state
+        self.display = display
+        self.scroll_step = scroll_step
+        self.ticks = []
+        self.score = None
+        self.dropped = None
+
+
+def read_blocks(path):
+    """Yields (session, sequence, records) for each log block in a file."""
+    with open(path, 'rb') as f:
+        while True:
+            block = f.read(BLOCK_SIZE)
+            if len(block) < BLOCK_SIZE:
+                return
+            magic, version, _, length, session, sequence = HEADER.unpack_from(block)
+            if magic != MAGIC:
+                continue
+            if version != VERSION:
+                raise LogError('block %d of session %08x has version %d' % (sequence, session, version))
+            if length > BLOCK_SIZE - HEADER.size:
+                raise LogError('block %d of session %08x is corrupt' % (sequence, session))
+            yield session, sequence, block[HEADER.size:HEADER.size + length]
+
+
+def read_sessions(path):
+    """Returns {session: [records, ...]} with each session's blocks in order."""
+    blocks = {}
+    for session, sequence, records in read_blocks(path):
+        # A later session overwrites the start of an earlier one, so the same
+        # block can only turn up twice on a card image (e.g. in a copy of the
+        # file); the first one wins.
+        blocks.setdefault(session, {}).setdefault(sequence, records)
+
+    sessions = {}
+    for session, by_sequence in blocks.items():
+        sequences = sorted(by_sequence)
+        missing = sorted(set(range(sequences[-1] + 1)) - set(sequences))
+        if missing:
+            sys.stderr.write('session %08x: %d blocks missing, starting at %d\n'
+                             % (session, len(missing), missing[0]))
+        sessions[session] = [by_sequence[s] for s in sequences]
+    return sessions
+
+
+def parse_rounds(blocks):
+    """Parses the records of a session's blocks into rounds."""
+    rounds = []
+    current = None
+    for data in blocks:
+        i = 0
+        while i < len(data):
+            kind = data[i]
+            i += 1
+            if kind == RECORD_ROUND_START:
+                current = Round(*ROUND_START.unpack_from(data, i))
+                rounds.append(current)
+                i += ROUND_START.size
+            elif kind == RECORD_TICK:
+                if current is not None:
+                    current.ticks.append(TICK.unpack_from(data, i))
+                i += TICK.size
+            elif kind == RECORD_ROUND_END:
+                if current is not None:
+                    current.score, current.dropped = ROUND_END.unpack_from(data, i)
+                current = None
+                i += ROUND_END.size
+            else:
+                raise LogError('unknown record type 0x%02x' % kind)
+    return rounds
+
+
+def print_summary(session, rounds):
+    print('session %08x: %d rounds' % (session, len(rounds)))
+    for n, r in enumerate(rounds):
+        update = [t[2] for t in r.ticks]
+        frame = [t[3] for t in r.ticks[1:]]
+        line = '  round %d: rng %08x, %s display, %d ticks' % (
+            n, r.rng_state, DISPLAYS.get(r.display, '?'), len(r.ticks))
+        if r.score is None:
+            line += ', unfinished'
+        else:
+            line += ', score %d' % r.score
+            if r.dropped:
+                line += ', %d records dropped' % r.dropped
+        print(line)
+        if update:
+            print('    update us: avg %d, max %d' % (sum(update) // len(update), max(update)))
+        if frame:
+            print('    frame us:  avg %d, max %d' % (sum(frame) // len(frame), max(frame)))
+
+
+def print_csv(session, rounds):
+    for n, r in enumerate(rounds):
+        for tick, (flags, step, update_us, frame_us, score) in enumerate(r.ticks):
+            print('%08x,%d,%d,%d,%d,%d,%d,%d,%d' % (
+                session, n, tick, flags & TICK_BUTTON and 1, flags & TICK_COLLISION and 1,
+                step, update_us, frame_us, score))
+
+
+def print_replay(session, rounds):
+    for n, r in enumerate(rounds):
+        inputs = ''.join('1' if t[0] & TICK_BUTTON else '0' for t in r.ticks)
+        steps = ''.join('%d' % t[1] for t in r.ticks)
+        print('%08x %d %08x %d %d %s %s' % (session, n, r.rng_state, r.display, r.scroll_step, inputs, steps))
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Reads the SD card log of ArduinoCopter.')
+    parser.add_argument('path', help='COPTER.LOG, a card image or a block device')
+    parser.add_argument('--session', type=lambda s: int(s, 16), help='session ID (hex)')
+    mode = parser.add_mutually_exclusive_group()
+    mode.add_argument('--csv', action='store_true', help='print one line per tick')
+    mode.add_argument('--replay', action='store_true', help='print the input of each round')
+    args = parser.parse_args(argv[1:])
+
+    try:
+        sessions = read_sessions(args.path)
+        if args.session is not None:
+            sessions = {s: b for s, b in sessions.items() if s == args.session}
+        if args.csv:
+            print('session,round,tick,button,collision,scroll_step,update_us,frame_us,score')
+        for session in sorted(sessions):
+            rounds = parse_rounds(sessions[session])
+            if args.csv:
+                print_csv(session, rounds)
+            elif args.replay:
+                print_replay(session, rounds)
+            else:
+                print_summary(session, rounds)
+    except (IOError, LogError) as e:
+        sys.stderr.write('%s: %s\n' % (argv[0], e))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+# ArduinoCopter
+# splash_converter.py
+#
+# Created October 19, 2026
+#
+# Converts an image into a splash screen for the game to stream from the SD
+# card (see arduino/copter/splash.h for the format). The image must be a binary
+# PPM (P6) the size of the display: 128x160 for the 1.8" LCD or 480x272 for the
+# 5" LCD. Most image tools can save one, e.g. `convert intro.png intro.ppm`.
+#
+# Usage: splash_converter.py <image.ppm> <output>
+#
+# Copy the output to the root directory of the card as INTRO.RAW, PAUSE.RAW or
+# OVER.RAW.
+
+import struct
+import sys
+
+MAGIC = b'CPSP'
+
+
+class ImageError(Exception):
+    pass
+
+
+def read_ppm(path):
+    """Returns (width, height, rgb bytes) of a binary PPM."""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    # The header is four whitespace separated fields, which may have comments
+    # between them, followed by a single whitespace character.
+    fields = []
+    i = 0
+    while len(fields) < 4:
+        while i < len(data) and data[i:i + 1].isspace():
+            i += 1
+        if data[i:i + 1] == b'#':
+            while i < len(data) and data[i:i + 1] != b'\n':
+                i += 1
+            continue
+        start = i
+        while i < len(data) and not data[i:i + 1].isspace():
+            i += 1
+        if start == i:
+            raise ImageError('truncated header')
+        fields.append(data[start:i])
+    i += 1
+
+    if fields[0] != b'P6':
+        raise ImageError('not a binary PPM (P6)')
+    width, height, maxval = (int(f) for f in fields[1:])
+    if maxval != 255:
+        raise ImageError('only 8 bits per channel are supported')
+    pixels = data[i:i + width * height * 3]
+    if len(pixels) != width * height * 3:
+        raise ImageError('truncated pixel data')
+    return width, height, pixels
+
+
+def to_rgb565(pixels):
+    """Packs RGB888 pixels into RGB565, high byte first."""
+    out = bytearray()
+    for i in range(0, len(pixels), 3):
+        r, g, b = pixels[i], pixels[i + 1], pixels[i + 2]
+        color = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+        out += struct.pack('>H', color)
+    return out
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write('usage: %s <image.ppm> <output>\n' % argv[0])
+        return 1
+    try:
+        width, height, pixels = read_ppm(argv[1])
+    except (IOError, ValueError, ImageError) as e:
+        sys.stderr.write('%s: %s: %s\n' % (argv[0], argv[1], e))
+        return 1
+    if (width, height) not in ((128, 160), (480, 272)):
+        sys.stderr.write('%s: warning: %dx%d is not the size of either display\n'
+                         % (argv[0], width, height))
+    with open(argv[2], 'wb') as f:
+        f.write(MAGIC + struct.pack('<HH', width, height))
+        f.write(to_rgb565(pixels))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))